@@ -0,0 +1,74 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+// the replaced global allocation functions keep the requested size in a header in front of each block,
+// so the bytes still allocated can be tracked on delete
+static std::atomic<size_t> allocations{0};
+static std::atomic<size_t> allocatedBytes{0};
+static std::atomic<size_t> liveBytes{0};
+
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+static void *countedAllocate(size_t size)
+{
+    auto *block = static_cast<unsigned char *>(std::malloc(size + HEADER_SIZE));
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    *reinterpret_cast<size_t *>(block) = size;
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    liveBytes.fetch_add(size, std::memory_order_relaxed);
+
+    return block + HEADER_SIZE;
+}
+
+static void countedFree(void *pointer)
+{
+    if (pointer == nullptr)
+        return;
+
+    auto *block = static_cast<unsigned char *>(pointer) - HEADER_SIZE;
+
+    liveBytes.fetch_sub(*reinterpret_cast<size_t *>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void *operator new(size_t size) { return countedAllocate(size); }
+void *operator new[](size_t size) { return countedAllocate(size); }
+
+// the nothrow forms too, or a block they allocate elsewhere (e.g. in a sanitizer's runtime) would reach countedFree
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return countedAllocate(size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { countedFree(pointer); }
+void operator delete(void *pointer) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { countedFree(pointer); }
+
+AllocationCounter::AllocationCounter()
+    : startAllocations(allocations.load(std::memory_order_relaxed)),
+      startAllocatedBytes(allocatedBytes.load(std::memory_order_relaxed)),
+      startLiveBytes(liveBytes.load(std::memory_order_relaxed))
+{
+}
+
+size_t AllocationCounter::getAllocations() const { return allocations.load(std::memory_order_relaxed) - startAllocations; }
+size_t AllocationCounter::getAllocatedBytes() const { return allocatedBytes.load(std::memory_order_relaxed) - startAllocatedBytes; }
+long long AllocationCounter::getLiveBytes() const { return static_cast<long long>(liveBytes.load(std::memory_order_relaxed)) - static_cast<long long>(startLiveBytes); }
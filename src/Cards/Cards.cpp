@@ -136,21 +136,28 @@ void Buffer::insert(const CardType type) noexcept
   m_card_count[type]++;
 }
 
-void Buffer::random_insert(const int &number) noexcept
+// Engine of the calling thread, for callers outside of a game: seeded once, not on every draw.
+static std::mt19937_64 &thread_rng()
 {
-  // Random index generated.
-  std::random_device rd;  // Generates a seed.
-  std::mt19937 rng(rd()); // Random seed
-  // Type goes from 0 to 4 inclusive.
-  std::uniform_int_distribution<> distrib(0, 4);
+  thread_local std::mt19937_64 rng(std::random_device{}());
+  return rng;
+}
 
-  // Random insertion.
+void Buffer::random_insert(const int &number, std::mt19937_64 &rng) noexcept
+{
+  // Random insertion, type goes from 0 to 4 inclusive.
+  // Drawn straight from the engine so a seed gives the same cards everywhere.
   for (int i = 0; i < number; i++)
   {
-    insert(CardType(distrib(rng)));
+    insert(CardType(rng() % 5));
   }
 }
 
+void Buffer::random_insert(const int &number) noexcept
+{
+  random_insert(number, thread_rng());
+}
+
 std::vector<CardType> Buffer::show_cards() const noexcept
 {
   // Creates array of same size as m_buffer.
@@ -190,17 +197,10 @@ const std::map<CardType, int> &Buffer::card_count() const noexcept
 Deck::Deck() : Buffer() {}
 Deck::Deck(const Deck &d) : Buffer(d) {}
 
-void Deck::draw(Hand &hand)
+void Deck::draw(Hand &hand, std::mt19937_64 &rng)
 {
-  const int end_index = m_buffer.size() - 1;
-
-  // Random index generated.
-  std::random_device rd;  // Generates a seed.
-  std::mt19937 rng(rd()); // Random seed
-  std::uniform_int_distribution<> distrib(0, end_index);
-
   // Index of card to be drawn.
-  const int index = distrib(rng);
+  const int index = rng() % m_buffer.size();
 
   // Removes the card from the m_buffer.
   auto sampled_card = this->remove(index);
@@ -208,6 +208,8 @@ void Deck::draw(Hand &hand)
   hand.insert(*sampled_card);
 }
 
+void Deck::draw(Hand &hand) { draw(hand, thread_rng()); }
+
 Deck &Deck::operator=(const Deck &d) noexcept
 {
   // Copies every element of the m_buffer to the new m_buffer.
@@ -1,7 +1,16 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
 
+#include "GameDurations.h"
 #include "GameEngine.h"
 #include "PlayerStrategies.h"
+#include "ThreadPool.h"
+#include "WorkStealingScheduler.h"
 
 using std::make_shared;
 using std::ostream;
@@ -154,7 +163,10 @@ string GameEngine::executeCommand(string input)
 
   if (!commandExecuted)
   {
-    std::cout << "Invalid command. Try again." << std::endl;
+    if (std::ostream *out = output->getStream())
+    {
+      *out << "Invalid command. Try again." << std::endl;
+    }
   }
 
   return *currState->phase;
@@ -172,7 +184,10 @@ std::string GameEngine::stringToLog() const
 void GameEngine::phase(std::string phase) noexcept
 {
   *currState->phase = std::move(phase);
-  Notify(this);
+  if (gameLog)
+  {
+    Notify(this);
+  }
 }
 
 bool validateStringCount(const std::string &input, std::vector<std::string> &result, int minCount, int maxCount)
@@ -214,7 +229,7 @@ bool validateNumber(int &result, int min, int max)
   return true;
 }
 
-void GameEngine::initiateTournament()
+void GameEngine::initiateTournament(const TournamentLimits &limits)
 {
   // Ask the list of maps, list of players, number of games per map, number of turns per game
   std::string maplist, playerlist;
@@ -223,32 +238,103 @@ void GameEngine::initiateTournament()
   std::vector<std::string> playerListVector;
   this->isTournament = true;
 
+  const auto range = [](int min, int max)
+  { return std::to_string(min) + "-" + std::to_string(max); };
+
   do
   {
-    std::cout << "Enter the list of maps (M, 1-5):" << std::endl;
+    std::cout << "Enter the list of maps (M, " << range(limits.minMaps, limits.maxMaps) << "):" << std::endl;
     std::cin >> maplist;
     std::cin.ignore(1000, '\n');
-  } while (!validateStringCount(maplist, mapListVector, 1, 5));
+  } while (!validateStringCount(maplist, mapListVector, limits.minMaps, limits.maxMaps));
 
   do
   {
-    std::cout << "Enter the list of players (P, 2-4):" << std::endl;
+    std::cout << "Enter the list of players (P, " << range(limits.minPlayers, limits.maxPlayers) << "):" << std::endl;
     std::cin >> playerlist;
     std::cin.ignore(1000, '\n');
-  } while (!validateStringCount(playerlist, playerListVector, 2, 4));
+  } while (!validateStringCount(playerlist, playerListVector, limits.minPlayers, limits.maxPlayers));
 
   do
   {
-    std::cout << "Enter the number of games per map (G, 1-5):" << std::endl;
-  } while (!validateNumber(numgames, 1, 5));
+    std::cout << "Enter the number of games per map (G, " << range(limits.minGames, limits.maxGames) << "):" << std::endl;
+  } while (!validateNumber(numgames, limits.minGames, limits.maxGames));
 
   do
   {
-    std::cout << "Enter the number of turns per game (D, 10-50):" << std::endl;
-  } while (!validateNumber(numturns, 10, 50));
+    std::cout << "Enter the number of turns per game (D, " << range(limits.minTurns, limits.maxTurns) << "):" << std::endl;
+  } while (!validateNumber(numturns, limits.minTurns, limits.maxTurns));
+
+  // Call the tournament method, with a fresh seed (logged, so the tournament can be replayed)
+  GameEngine::startTournament(mapListVector, playerListVector, numgames, numturns, std::random_device{}());
+}
+
+int GameEngine::runTournament(const TournamentConfig &config)
+{
+  std::string error;
+  if (!config.validate(error))
+  {
+    std::cout << "Invalid tournament: " << error << std::endl;
+    return 1;
+  }
+
+  // without a seed, a fresh one (printed in the log, so the tournament can be replayed)
+  const uint64_t seed = config.hasSeed ? config.seed : std::random_device{}();
+  size_t missingShards = 0;
+
+  this->quiet = config.quiet;
+  this->gameLog = config.gameLog;
+  this->stalemate = config.stalemate;
+
+  try
+  {
+    if (config.shardCount > 0)
+    {
+      // a single shard, typically one that crashed, then the merge of every shard there is
+      if (!runTournamentShard(config.maps, config.players, config.numGames, config.numTurns, seed, config.shard - 1, config.shardCount,
+                              config.resultsDirectory, config.threads))
+      {
+        return 1;
+      }
+      missingShards = mergeTournamentShards(config.maps, config.players, config.numGames, config.numTurns, seed, config.shardCount,
+                                            config.resultsDirectory);
+    }
+    else if (config.processes > 1)
+    {
+      missingShards = startShardedTournament(config.maps, config.players, config.numGames, config.numTurns, seed, config.processes,
+                                             config.resultsDirectory, config.threads);
+    }
+    else
+    {
+      startTournament(config.maps, config.players, config.numGames, config.numTurns, seed, config.threads);
+    }
+  }
+  catch (const std::invalid_argument &exception)
+  {
+    // an unknown player type
+    std::cout << "Invalid tournament: " << exception.what() << std::endl;
+    return 1;
+  }
+
+  if (tournament_log.empty())
+  {
+    return 1;
+  }
+
+  if (!config.outputPath.empty())
+  {
+    std::ofstream output(config.outputPath, std::ios::trunc);
+    output << tournament_log << std::endl;
+
+    if (!output)
+    {
+      std::cout << "Can't write the results to " << config.outputPath << std::endl;
+      return 1;
+    }
+    std::cout << "Results written to " << config.outputPath << std::endl;
+  }
 
-  // Call the tournament method
-  GameEngine::startTournament(mapListVector, playerListVector, numgames, numturns);
+  return missingShards == 0 ? 0 : 2;
 }
 
 // void GameEngine::startupPhase(CommandProcessor* cmdProcessor)
@@ -339,6 +425,13 @@ void GameEngine::startupPhase()
       // Logic to start the game
       // a) Distribute territories
       const auto territories = Map::getAllTerritories(*map);
+      // an interactive game gets a fresh seed; it's printed so the game can be replayed
+      this->game = std::make_shared<GameState>(map, std::random_device{}());
+      cout << "Game seed: " << game->getSeed() << endl;
+      for (auto &&player : players)
+      {
+        player->joinGame(game.get());
+      }
 
       auto size = static_cast<double>(territories.size());
       cout << size << " total territories" << endl;
@@ -360,10 +453,7 @@ void GameEngine::startupPhase()
       // players[1]->getTerritories();
       //  b) Randomize order of play
       std::cout << "\nRandomizing player order\n==========================================================\n";
-      std::random_device rd; // Obtain a random number from hardware
-      std::mt19937 g(rd());  // Seed the generator
-      std::shuffle(players.begin(), players.end(),
-                   g); // Shuffle the players vector
+      game->shuffle(players.begin(), players.end()); // Shuffle the players vector
 
       // PRINT
       std::cout << "Order of play:" << std::endl;
@@ -384,7 +474,7 @@ void GameEngine::startupPhase()
       // d) Deal initial cards
       std::cout << "==========================================================\nDealing initial cards to each player...\n";
       Deck deck;
-      deck.random_insert(100);
+      deck.random_insert(100, game->getRng());
       for (auto &player : players)
       {
         std::cout << "\nplayer ";
@@ -393,8 +483,8 @@ void GameEngine::startupPhase()
         // std::cout << player->getHand()<< std::endl;
 
         // Each player draws two cards
-        deck.draw(*player->getHand()); // First card
-        deck.draw(*player->getHand()); // Second card
+        deck.draw(*player->getHand(), game->getRng()); // First card
+        deck.draw(*player->getHand(), game->getRng()); // Second card
 
         // std::cout <<  player->getHand()->show_cards().size() << std::endl;
 
@@ -440,51 +530,31 @@ void GameEngine::startupPhase()
 
 void GameEngine::reinforcementPhase(vector<Player *> players, const Map &gameMap)
 {
-  cout << "Reinforcement Phase Starting" << endl;
-
-  const auto continents = Map::getAllContinents(gameMap);
+  std::ostream *out = output->getStream();
+  if (out)
+  {
+    *out << "Reinforcement Phase Starting\n";
+  }
 
   // for each player, give reinforcements based on territories owned
+  // (the game state keeps the ownership counters up to date, so this is O(players + continents) whatever the map size)
   for (auto &&player : players)
   {
+    const GameState &game = *player->getGame();
     int continent_bonus = 0;
 
     // 1 army for every 3 territories owned rounded down
-    int territory_reinforcement_count = static_cast<int>(player->getTerritories().size() / 3);
-
-    // map of number of territories owned per continent: <continent name, number of territories owned>
-    ::map<string, int> num_terr_per_continent;
+    int territory_reinforcement_count = static_cast<int>(game.getTerritoryCount(player->getSlot()) / 3);
 
-    // count number of territories owned per continent for this player
-    for (auto &&territory : player->getTerritories())
-    {
-      string territoryContinent = territory->getContinent()->getName();
-      bool missing_from_map = num_terr_per_continent.find(territoryContinent) == num_terr_per_continent.end();
-
-      if (missing_from_map)
-      {
-        num_terr_per_continent[territoryContinent] = 1;
-      }
-      else
-      {
-        num_terr_per_continent[territoryContinent]++;
-      }
-    }
-
-    // check if player owns all territories in a continent by matching the number of territories owned per continent
-    // with the total number of territories in that continent
-    for (auto &&continent : continents)
-    {
-      if (num_terr_per_continent.find(continent->getName()) != num_terr_per_continent.end())
+    // add the bonus of every continent the player owns all territories in
+    game.forEachOwnedContinent(player->getSlot(), [&](ContinentId continentId)
+                               {
+      const Continent *continent = Map::getContinent(gameMap, continentId);
+      if (out)
       {
-        if (num_terr_per_continent[continent->getName()] == continent->getTerritoryCount())
-        {
-          std::cout << "Player " << player->getName() << " owns all territories in " << continent->getName()
-                    << std::endl;
-          continent_bonus += continent->getBonus();
-        }
+        *out << "Player " << player->getName() << " owns all territories in " << continent->getName() << '\n';
       }
-    }
+      continent_bonus += continent->getBonus(); });
 
     int reinforcements = territory_reinforcement_count + continent_bonus;
 
@@ -494,37 +564,57 @@ void GameEngine::reinforcementPhase(vector<Player *> players, const Map &gameMap
       reinforcements = 3;
     }
 
-    cout << player->getName() << " gets " << reinforcements << " reinforcements: "
-         << territory_reinforcement_count << " from territories and "
-         << continent_bonus << " from continent bonuses." << endl;
+    if (out)
+    {
+      *out << player->getName() << " gets " << reinforcements << " reinforcements: "
+           << territory_reinforcement_count << " from territories and "
+           << continent_bonus << " from continent bonuses.\n";
+    }
 
     // give player reinforcements
     for (int i = 0; i < reinforcements; i++)
     {
       player->getHand()->insert(Card(CardType::reinforcement));
     }
-    player->getHand()->random_insert(1); // give a random card
+    player->getHand()->random_insert(1, player->getGame()->getRng()); // give a random card
+  }
+  if (out)
+  {
+    *out << "Reinforcement Phase End\n";
   }
-  cout << "Reinforcement Phase End" << endl;
 }
 
 void GameEngine::issueOrdersPhase(vector<Player *> players, const Map &gameMap)
 {
-  cout << "Issue Orders Phase Starting" << endl;
+  std::ostream *out = output->getStream();
+  if (out)
+  {
+    *out << "Issue Orders Phase Starting\n";
+  }
 
   // for each player, issue orders
   for (auto &&player : players)
   {
     player->issueOrder(gameMap, players);
-    cout << "Player " << player->getName() << " has issued " << player->getPlayerOrderList()->list.size() << " orders" << endl;
+    if (out)
+    {
+      *out << "Player " << player->getName() << " has issued " << player->getPlayerOrderList()->list.size() << " orders\n";
+    }
   }
 
-  cout << "Issue Orders Phase End" << endl;
+  if (out)
+  {
+    *out << "Issue Orders Phase End\n";
+  }
 }
 
 void GameEngine::executeOrdersPhase(vector<Player *> players)
 {
-  cout << "Execute Orders Phase Starting" << endl;
+  std::ostream *out = output->getStream();
+  if (out)
+  {
+    *out << "Execute Orders Phase Starting\n";
+  }
 
   // while all players still have orders left
   size_t players_with_deploys_left = players.size();
@@ -576,7 +666,24 @@ void GameEngine::executeOrdersPhase(vector<Player *> players)
     }
   }
 
-  cout << "Execute Orders Phase End" << endl;
+  if (out)
+  {
+    *out << "Execute Orders Phase End\n";
+  }
+}
+
+// Removes every player with no territories left from the list of players, saying so on `out` (if not nullptr)
+static void removeDefeatedPlayers(vector<Player *> &players, std::ostream *out)
+{
+  players.erase(std::remove_if(players.begin(), players.end(), [&](Player *player)
+                               {
+                                 if (!player->getTerritories().empty())
+                                   return false;
+
+                                 if (out)
+                                   *out << player->getName() << " has no territories left. Player will be removed.\n";
+                                 return true; }),
+                players.end());
 }
 
 std::string GameEngine::mainGameLoop(vector<Player *> players, const Map &gameMap, int numTurns)
@@ -585,23 +692,24 @@ std::string GameEngine::mainGameLoop(vector<Player *> players, const Map &gameMa
   // Check if gamestart was called
   if (getPhase() != "assign reinforcements")
   {
-    cout << "Error: Game start has not been called" << endl;
+    if (std::ostream *out = output->getStream())
+    {
+      *out << "Error: Game start has not been called" << std::endl;
+    }
     return "Wrong State";
   }
 
+  // stalled games end early, if the rules say so
+  std::optional<StalemateDetector> stalemateDetector;
+  if (stalemate.isEnabled() && !players.empty())
+  {
+    stalemateDetector.emplace(stalemate, *players[0]->getGame());
+  }
+
   while (getPhase() != "end")
   {
     // check if a player has no territories (delete function because players don't start with 0 territories)
-    for (auto &&player : players)
-    {
-      if (player->getTerritories().empty())
-      {
-        cout << player->getName() << " has no territories left. Player will be removed." << endl;
-        // remove player from list of players
-        players.erase(std::remove(players.begin(), players.end(), player), players.end());
-        break;
-      }
-    }
+    removeDefeatedPlayers(players, output->getStream());
 
     reinforcementPhase(players, gameMap);
     executeCommand("issueorder");
@@ -611,31 +719,43 @@ std::string GameEngine::mainGameLoop(vector<Player *> players, const Map &gameMa
 
     executeOrdersPhase(players);
 
-    // check if a player has no territories
-    for (auto &&player : players)
-    {
-      if (player->getTerritories().empty())
-      {
-        cout << player->getName() << " has no territories left. Player will be removed." << endl;
-        // remove player from list of players
-        players.erase(std::remove(players.begin(), players.end(), player), players.end());
-        break;
-      }
-    }
+    // check if a player has no territories (several can be defeated in one turn)
+    removeDefeatedPlayers(players, output->getStream());
 
     // check if there is only one player left
     if (players.size() == 1)
     {
-      cout << players[0]->getName() << " has won the game!" << endl;
+      if (std::ostream *out = output->getStream())
+      {
+        *out << players[0]->getName() << " has won the game!\n";
+      }
+      output->flush();
       // must be in execute orders state to win
       executeCommand("win");
       return players[0]->getName();
     }
 
+    // check if the game has stalled: nothing left to play for but the turns
+    if (stalemateDetector && !players.empty())
+    {
+      const auto reason = stalemateDetector->endTurn(*players[0]->getGame());
+      if (reason != StalemateDetector::Reason::NONE)
+      {
+        if (std::ostream *out = output->getStream())
+        {
+          *out << stalemateDetector->explain(reason) << ": " << stalemate.result << '\n';
+        }
+        executeCommand("win");
+        output->flush();
+        return stalemate.result;
+      }
+    }
+
     if (numTurns != -1 && currTurns >= numTurns)
     {
       // cout << "Reached max number of turns" << endl;
       executeCommand("win");
+      output->flush();
       std::string biggestPlayerNameLeft;
       int biggestPlayerTerritoriesLeft = -1;
 
@@ -659,170 +779,359 @@ std::string GameEngine::mainGameLoop(vector<Player *> players, const Map &gameMa
     }
 
     executeCommand("endexecorders");
+    output->flush();
     currTurns++;
   }
   return "Draw";
 }
 
-void GameEngine::startTournament(std::vector<std::string> mapList, std::vector<std::string> playerList, int numGames, int numTurns)
+// Creates a tournament player from its strategy name (any case), or nullptr when there is no such strategy
+static Player *createTournamentPlayer(std::string type, int index)
 {
-  std::vector<shared_ptr<Map>> mapsInTournament;
-  std::vector<Player *> playersInTournament;
-  std::string mapsLine = "";
-  std::string playersLine = "";
+  // lowercase the string
+  std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+  PlayerStrategy *strategy = nullptr;
+
+  // Assign the player strategy
+  if (type == "aggressive")
+  {
+    strategy = new AggressivePlayer();
+  }
+  else if (type == "benevolent")
+  {
+    strategy = new BenevolentPlayer();
+  }
+  else if (type == "neutral")
+  {
+    strategy = new NeutralPlayer();
+  }
+  else if (type == "cheater")
+  {
+    strategy = new CheaterPlayer();
+  }
+  else
+  {
+    return nullptr;
+  }
+
+  auto *player = new Player(index, type + std::to_string(index + 1));
+  player->setStrategy(strategy);
+  delete strategy; // setStrategy keeps a clone
+
+  return player;
+}
+
+std::string GameEngine::playTournamentGame(const shared_ptr<Map> &map, const vector<std::string> &playerList, int gameIndex, int numTurns, uint64_t seed,
+                                           OutputSink &output, const StalemateRules &stalemate, bool gameLog)
+{
+  // the game's own engine (states and commands), players and state: nothing is shared with the games beside it
+  GameEngine engine;
+  engine.isTournament = true;
+  engine.map = map;
+  engine.output = &output;
+  engine.stalemate = stalemate;
+  engine.gameLog = gameLog;
+
+  vector<Player *> players;
+  for (size_t i = 0; i < playerList.size(); i++)
+  {
+    players.push_back(createTournamentPlayer(playerList[i], i));
+  }
+
+  engine.executeCommand("loadmap");
+  engine.executeCommand("validate");
+  engine.executeCommand("addplayers");
+  engine.executeCommand("assigncountries");
+
+  // every game starts from its own state, with no territory owned, and its own seed
+  GameState game(map, seed);
+  game.setOutput(output);
+  game.setLogged(gameLog);
+  for (auto player : players)
+  {
+    player->joinGame(&game);
+  }
+
+  // assign countries to players
+  const auto territories = Map::getAllTerritories(*map);
+  auto size = static_cast<double>(territories.size());
+  std::ostream *out = output.getStream();
+  if (out)
+  {
+    *out << size << " total territories\n";
+  }
+  for (int x = 0; x < size; x++)
+  {
+    Territory *territory = &*territories[x];
+    int playerIndex = x % players.size();
+    players[playerIndex]->addTerritory(territory);
+  }
+
+  if (out)
+  {
+    *out << "Starting game " << gameIndex + 1 << '\n';
+  }
+  // Start the game, returns name of player or draw if no winner
+  std::string result = engine.mainGameLoop(players, *map, numTurns);
+
+  for (auto player : players)
+  {
+    delete player;
+  }
+
+  return result;
+}
+
+bool GameEngine::loadTournament(const vector<std::string> &mapList, const vector<std::string> &playerList, vector<shared_ptr<Map>> &maps,
+                                vector<std::string> &mapPaths, std::string &mapsLine, std::string &playersLine)
+{
+  maps.clear();
+  mapPaths.clear();
+  mapsLine = "";
+  playersLine = "";
 
   std::cout << "Starting to validate maps and players.." << std::endl;
 
   // Check if the maps can be loaded and valid
+  // the maps are loaded and validated concurrently (validated maps are compiled next to their source, so later
+  // tournaments skip parsing and validation); the first invalid map cancels the ones after it
   for (auto mapstr : mapList)
   {
-    // Load the map
-    string map_path = "maps/" + mapstr + ".map";
-    std::cout << "Loading map: " << map_path << std::endl;
-    shared_ptr<Map> loadedMap = MapLoader::loadMap(map_path);
-    Map::validate(loadedMap.get());
+    mapPaths.push_back("maps/" + mapstr + ".map");
+  }
+
+  std::vector<shared_ptr<Map>> loadedMaps;
+  {
+    ThreadPool pool(std::min<size_t>(std::thread::hardware_concurrency(), mapPaths.size()));
+    loadedMaps = MapLoader::loadMapsCached(mapPaths, pool);
+  }
+
+  for (size_t i = 0; i < mapList.size(); i++)
+  {
+    std::cout << "Loading map: " << mapPaths[i] << std::endl;
+    shared_ptr<Map> loadedMap = loadedMaps[i];
 
     // check validation
     if (loadedMap->getValidity() == MapValidity::VALID)
     {
-      std::cout << "valid map: " << map_path << std::endl;
-      mapsInTournament.push_back(loadedMap);
+      std::cout << "valid map: " << mapPaths[i] << std::endl;
+      maps.push_back(loadedMap);
     }
     else
     {
-      std::cout << "invalid map: " << map_path << std::endl;
-      return;
+      std::cout << "invalid map: " << mapPaths[i] << std::endl;
+      return false;
     }
 
     // Game log
     mapsLine += loadedMap->getImage();
-    if (mapstr != mapList.back())
+    if (mapList[i] != mapList.back())
     {
       mapsLine += ", ";
     }
   }
 
   std::cout << "Maps loaded and validated" << std::endl;
-  int index = 0;
-  // Validate and turn the players into objects
-  for (auto playerstr : playerList)
+  // Validate the players (every game creates its own)
+  for (size_t index = 0; index < playerList.size(); index++)
   {
-    // lowercase the string
-    std::transform(playerstr.begin(), playerstr.end(), playerstr.begin(), ::tolower);
-
-    auto *player = new Player(index, playerstr + std::to_string(index + 1));
-
-    // Assign the player strategy
-    if (playerstr == "aggressive")
+    Player *player = createTournamentPlayer(playerList[index], index);
+    if (player == nullptr)
     {
-      player->setStrategy(new AggressivePlayer());
+      throw std::invalid_argument("Invalid player type: " + playerList[index]);
     }
-    else if (playerstr == "benevolent")
-    {
-      player->setStrategy(new BenevolentPlayer());
-    }
-    else if (playerstr == "neutral")
+
+    // Game log
+    playersLine += player->getName();
+    if (index + 1 < playerList.size())
     {
-      player->setStrategy(new NeutralPlayer());
+      playersLine += ", ";
     }
-    else if (playerstr == "cheater")
+
+    delete player;
+  }
+  std::cout << "Players loaded and validated" << std::endl;
+
+  return true;
+}
+
+WorkStealingScheduler::Stats GameEngine::playTournamentGames(const vector<shared_ptr<Map>> &maps, const vector<std::string> &mapPaths, const vector<std::string> &playerList,
+                                                             int numGames, int numTurns, uint64_t seed, const vector<size_t> &games, size_t threadCount, bool longestFirst,
+                                                             bool quiet, bool gameLog, const StalemateRules &stalemate, const std::function<void(size_t, const std::string &, const std::string &)> &onGameFinished)
+{
+  // the games are independent, so they're spread over the workers by a work-stealing scheduler (longest expected
+  // first, from the durations of past games on each map); each writes its messages to its own buffered sink (or, when
+  // quiet, to a null sink, so nothing is formatted), handed over in the order of `games` as soon as the games before it are done
+  if (threadCount == 0)
+  {
+    threadCount = std::thread::hardware_concurrency();
+  }
+
+  std::vector<size_t> order(games.size());
+  for (size_t position = 0; position < games.size(); position++)
+  {
+    order[position] = position;
+  }
+
+  GameDurations durations("maps");
+  if (longestFirst)
+  {
+    // maps never played come first: nothing says they're short
+    std::stable_sort(order.begin(), order.end(), [&](size_t position1, size_t position2)
+                     {
+                       const double expected1 = durations.getExpectedSeconds(mapPaths[games[position1] / numGames]);
+                       const double expected2 = durations.getExpectedSeconds(mapPaths[games[position2] / numGames]);
+                       return (expected1 < 0 ? INFINITY : expected1) > (expected2 < 0 ? INFINITY : expected2); });
+  }
+
+  std::vector<std::string> gameOutputs(games.size());
+  std::vector<std::string> results(games.size());
+  std::vector<bool> finished(games.size(), false);
+  size_t nextToHandOver = 0;
+  std::mutex handOverMutex;
+  auto lastProgress = std::chrono::steady_clock::now();
+
+  const auto playGame = [&](size_t position)
+  {
+    const size_t m = games[position] / numGames;
+    const int i = games[position] % numGames;
+    const uint64_t gameSeed = GameState::getGameSeed(seed, m, i);
+
+    if (quiet)
     {
-      player->setStrategy(new CheaterPlayer());
+      NullSink output;
+      results[position] = playTournamentGame(maps[m], playerList, i, numTurns, gameSeed, output, stalemate, gameLog);
     }
     else
     {
-      throw std::invalid_argument("Invalid player type: " + playerstr);
+      BufferedSink output;
+      results[position] = playTournamentGame(maps[m], playerList, i, numTurns, gameSeed, output, stalemate, gameLog);
+      gameOutputs[position] = output.take();
     }
+  };
 
-    playersInTournament.push_back(player);
-    index++;
+  const auto handOverFinishedGames = [&](size_t position, size_t gamesDone)
+  {
+    std::lock_guard<std::mutex> lock(handOverMutex);
+    finished[position] = true;
 
-    // Game log
-    playersLine += player->getName();
-    if (index < playerList.size())
+    for (; nextToHandOver < games.size() && finished[nextToHandOver]; nextToHandOver++)
     {
-      playersLine += ", ";
+      onGameFinished(games[nextToHandOver], results[nextToHandOver], gameOutputs[nextToHandOver]);
+      std::string().swap(gameOutputs[nextToHandOver]);
     }
+
+    // at most once a second (and once at the end), and not at all when quiet: a big batch would spend its time printing
+    const auto now = std::chrono::steady_clock::now();
+    if (!quiet && (gamesDone == games.size() || now - lastProgress >= std::chrono::seconds(1)))
+    {
+      lastProgress = now;
+      std::cout << "Progress: " << gamesDone << "/" << games.size() << " games played\n";
+    }
+  };
+
+  const auto stats = WorkStealingScheduler::run(threadCount, order, playGame, handOverFinishedGames);
+
+  for (size_t position = 0; position < games.size(); position++)
+  {
+    durations.record(mapPaths[games[position] / numGames], stats.jobSeconds[position]);
   }
-  std::cout << "Players loaded and validated" << std::endl;
-  this->isTournament = true;
+  durations.save();
 
-  // Game log
-  std::string log = "Tournament mode:\nM: " + mapsLine + "\nP: " + playersLine + "\nG: " +
-                    std::to_string(numGames) + "\nD: " + std::to_string(numTurns) + "\n\n" + formatForTable("Results:");
+  // the tournament can't take less than its longest game: the closer the two, the better the games were spread
+  std::cout << "Played " << games.size() << " games on " << stats.workers.size() << " threads in " << stats.wallSeconds * 1000
+            << " ms (longest game " << stats.getLongestJobSeconds() * 1000 << " ms), utilisation "
+            << stats.getUtilisation() * 100 << "%" << std::endl;
+  for (size_t worker = 0; !quiet && worker < stats.workers.size(); worker++)
+  {
+    const auto &workerStats = stats.workers[worker];
+    std::cout << "  worker " << worker + 1 << ": " << workerStats.jobs << " games (" << workerStats.steals << " stolen), busy "
+              << workerStats.busySeconds * 1000 << " ms\n";
+  }
+
+  return stats;
+}
+
+std::string GameEngine::formatTournamentHeader(const std::string &mapsLine, const std::string &playersLine, int numGames, int numTurns, uint64_t seed,
+                                               const StalemateRules &stalemate)
+{
+  std::string header = "Tournament mode:\nM: " + mapsLine + "\nP: " + playersLine + "\nG: " + std::to_string(numGames) +
+                       "\nD: " + std::to_string(numTurns) + "\nS: " + std::to_string(seed);
+
+  // only there when stalled games end early (their results depend on it), so other tournaments log as they always have
+  if (stalemate.isEnabled())
+  {
+    header += "\nStalemate: " + stalemate.describe() + " (" + stalemate.result + ")";
+  }
+
+  return header;
+}
+
+std::string GameEngine::formatTournamentLog(const std::string &header, const vector<std::string> &images, const vector<std::string> &results, int numGames, size_t mapCount)
+{
+  std::string log = header + "\n\n" + formatForTable("Results:");
   for (int i = 1; i <= numGames; i++)
   {
     log += formatForTable("Game " + std::to_string(i));
   }
 
-  // Start the tournament
-  for (auto map : mapsInTournament)
+  for (size_t m = 0; m < mapCount; m++)
   {
-    this->map = map;
-    log += "\n" + formatForTable(map->getImage());
+    log += "\n" + formatForTable(images[m]);
     for (int i = 0; i < numGames; i++)
     {
-      executeCommand("loadmap");
-      executeCommand("validate");
-      executeCommand("addplayers");
+      log += formatForTable(results[m * numGames + i]);
+    }
+    log += "\n";
+  }
 
-      // DEBUG: list players
-      /*std::cout << "Players in tournament: " << std::endl;
-      for (auto player : playersInTournament)
-      {
-          std::cout << player->getName() << std::endl;
-      }*/
+  return log;
+}
 
-      executeCommand("assigncountries");
-      // assign countries to players
-      const auto territories = Map::getAllTerritories(*map);
-      auto size = static_cast<double>(territories.size());
-      cout << size << " total territories" << endl;
-      for (int x = 0; x < size; x++)
-      {
-        Territory *territory = &*territories[x];
-        int playerIndex = x % playersInTournament.size();
-        playersInTournament[playerIndex]->addTerritory(territory);
-      }
+void GameEngine::startTournament(std::vector<std::string> mapList, std::vector<std::string> playerList, int numGames, int numTurns, uint64_t seed, size_t threadCount, bool longestFirst)
+{
+  std::vector<shared_ptr<Map>> mapsInTournament;
+  std::vector<std::string> mapPaths;
+  std::string mapsLine, playersLine;
 
-      // DEBUG: print all players and their territories
-      /*for (int j = 0; j < playersInTournament.size(); j++)
-      {
-          std::cout << "Printing player: " << j + 1 << " territories:\n";
-          for (Territory *t : playersInTournament[j]->getTerritories())
-          {
-              cout << *t << endl;
-          }
-      }*/
-
-      // DEBUG: print all players and territory count
-      //        for (auto player : playersInTournament)
-      //        {
-      //            std::cout << "Player: " << player->getName() << " has " << player->getTerritories().size() << " territories" << std::endl;
-      //        }
-
-      // DEBUG: print all territories and their owner
-      //        for (const auto& t : territories)
-      //        {
-      //            std::cout << "Territory: " << t->getName() << " owned by: " << t->getOwner()->getName() << std::endl;
-      //        }
-
-      std::cout << "Starting game " << i + 1 << std::endl;
-      // Start the game, returns name of player or draw if no winner
-      std::string result = mainGameLoop(playersInTournament, *map, numTurns);
-      log += formatForTable(result);
-
-      // play again
-      executeCommand("play");
-
-      for (auto player : playersInTournament)
-      {
-        player->resetNewGame();
-      }
-    }
-    log += "\n";
-    std::cout << log << std::endl;
+  if (!loadTournament(mapList, playerList, mapsInTournament, mapPaths, mapsLine, playersLine))
+  {
+    return;
+  }
+  this->isTournament = true;
+
+  // Game log
+  const std::string header = formatTournamentHeader(mapsLine, playersLine, numGames, numTurns, seed, stalemate);
+  std::vector<std::string> images;
+  for (auto &&map : mapsInTournament)
+  {
+    images.push_back(map->getImage());
   }
+
+  // Start the tournament
+  // every game is played, and printed in game order along with the table as each map's games are done
+  std::vector<size_t> games(mapsInTournament.size() * numGames);
+  std::vector<std::string> results(games.size());
+  for (size_t game = 0; game < games.size(); game++)
+  {
+    games[game] = game;
+  }
+
+  std::string log;
+  const size_t gamesPerMap = numGames;
+  this->lastTournamentStats = playTournamentGames(mapsInTournament, mapPaths, playerList, numGames, numTurns, seed, games, threadCount, longestFirst, quiet, gameLog, stalemate,
+                                                  [&](size_t game, const std::string &result, const std::string &output)
+                                                  {
+                                                    std::cout << output;
+                                                    results[game] = result;
+
+                                                    if (game % gamesPerMap == gamesPerMap - 1)
+                                                    {
+                                                      log = formatTournamentLog(header, images, results, numGames, game / gamesPerMap + 1);
+                                                      std::cout << log << std::endl;
+                                                    }
+                                                  });
   this->tournament_log = log;
   Notify(this);
 }
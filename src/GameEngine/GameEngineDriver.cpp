@@ -59,6 +59,12 @@ void testMainGameLoop()
     list_players.push_back(p4);
     list_players.push_back(p5);
 
+    GameState game(gameMap);
+    for (auto &&player : list_players)
+    {
+        player->joinGame(&game);
+    }
+
     // Test: split territories between p1, p2, p3, and p4 (10%, 20%, 10%, 60%)
     auto size = static_cast<double>(territories.size());
     cout << size << " total territories" << endl;
@@ -129,10 +135,14 @@ void testMainGameLoop()
     list_players2.push_back(p6);
     list_players2.push_back(p7);
 
+    GameState game2(gameMap);
+    p6->joinGame(&game2);
+    p7->joinGame(&game2);
+
     // Test: give all territories to p6
     for (int i = 0; i < size; i++)
     {
-        p6->addTerritory(territories[i].get());
+        p6->addTerritory(territories[i]);
     }
 
     // Test: move current state to reinforcement phase
@@ -0,0 +1,86 @@
+#include "GameState.h"
+
+GameState::GameState(std::shared_ptr<const Map> map, uint64_t seed)
+    : map(std::move(map)), owners(this->map->getTerritoryCount(), NO_OWNER), units(this->map->getTerritoryCount(), 0), seed(seed), rng(seed)
+{
+    continentSizes.resize(this->map->getContinentCount());
+    continentWords = (continentSizes.size() + 63) / 64;
+
+    for (ContinentId continent = 0; continent < continentSizes.size(); continent++)
+        continentSizes[continent] = static_cast<uint32_t>(Map::getTerritoryIdsInContinent(*this->map, continent).size());
+}
+
+// splitmix64 finalizer: nearby inputs give unrelated outputs
+static uint64_t mix(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+uint64_t GameState::getGameSeed(uint64_t tournamentSeed, size_t mapIndex, size_t gameIndex)
+{
+    return mix(mix(mix(tournamentSeed) ^ mapIndex) ^ gameIndex);
+}
+
+uint64_t GameState::getOwnershipHash() const
+{
+    uint64_t hash = owners.size();
+    for (const auto owner : owners)
+        hash = mix(hash ^ owner);
+    return hash;
+}
+
+uint64_t GameState::getStateHash() const
+{
+    uint64_t hash = getOwnershipHash();
+    for (const auto territoryUnits : units)
+        hash = mix(hash ^ static_cast<uint32_t>(territoryUnits));
+    return hash;
+}
+
+const Map &GameState::getMap() const { return *map; }
+const std::shared_ptr<const Map> &GameState::getSharedMap() const { return map; }
+
+GameState::PlayerSlot GameState::addPlayer(Player *player)
+{
+    if (players.size() >= MAX_PLAYERS)
+        return NO_OWNER;
+
+    players.push_back(player);
+    territoryCounts.push_back(0);
+    continentCounts.resize(continentCounts.size() + continentSizes.size(), 0);
+    ownedContinents.resize(ownedContinents.size() + continentWords, 0);
+
+    return static_cast<PlayerSlot>(players.size() - 1);
+}
+
+void GameState::setOwner(TerritoryId territory, PlayerSlot owner)
+{
+    const auto previous = owners[territory];
+
+    if (previous == owner)
+        return;
+
+    owners[territory] = owner;
+
+    const auto continent = Map::getContinentId(*map, territory);
+    const auto bit = uint64_t(1) << (continent % 64);
+
+    // a continent stops being fully owned by its previous owner, and may become fully owned by the new one
+    if (previous != NO_OWNER)
+    {
+        territoryCounts[previous]--;
+        continentCounts[previous * continentSizes.size() + continent]--;
+        ownedContinents[previous * continentWords + continent / 64] &= ~bit;
+    }
+
+    if (owner != NO_OWNER)
+    {
+        territoryCounts[owner]++;
+
+        if (++continentCounts[owner * continentSizes.size() + continent] == continentSizes[continent])
+            ownedContinents[owner * continentWords + continent / 64] |= bit;
+    }
+}
@@ -0,0 +1,26 @@
+#include <iostream>
+
+#include "OutputSink.h"
+
+OutputSink &OutputSink::console()
+{
+    static ConsoleSink console;
+    return console;
+}
+
+std::ostream *ConsoleSink::getStream()
+{
+    return &std::cout;
+}
+
+void ConsoleSink::flush()
+{
+    std::cout.flush();
+}
+
+std::string BufferedSink::take()
+{
+    std::string messages = buffer.str();
+    buffer.str(std::string());
+    return messages;
+}
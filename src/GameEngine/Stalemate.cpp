@@ -0,0 +1,64 @@
+#include "Stalemate.h"
+
+std::string StalemateRules::describe() const
+{
+  std::string description;
+  if (window > 0)
+  {
+    description = "no capture in " + std::to_string(window) + " turns";
+  }
+  if (repeatedState)
+  {
+    description += (description.empty() ? "" : ", ") + std::string("repeated state");
+  }
+
+  return description.empty() ? "off" : description;
+}
+
+StalemateDetector::StalemateDetector(const StalemateRules &rules, const GameState &game) : rules(rules), ownership(game.getOwnershipHash())
+{
+  if (rules.repeatedState)
+  {
+    turnsByState.emplace(game.getStateHash(), 0);
+  }
+}
+
+StalemateDetector::Reason StalemateDetector::endTurn(const GameState &game)
+{
+  turn++;
+
+  // a territory changing hands is progress, units coming and going isn't
+  const uint64_t newOwnership = game.getOwnershipHash();
+  turnsWithoutProgress = newOwnership == ownership ? turnsWithoutProgress + 1 : 0;
+  ownership = newOwnership;
+
+  if (rules.window > 0 && turnsWithoutProgress >= rules.window)
+  {
+    return Reason::NO_PROGRESS;
+  }
+
+  if (rules.repeatedState)
+  {
+    const auto [seen, added] = turnsByState.emplace(game.getStateHash(), turn);
+    if (!added)
+    {
+      repeatedTurn = seen->second;
+      return Reason::REPEATED_STATE;
+    }
+  }
+
+  return Reason::NONE;
+}
+
+std::string StalemateDetector::explain(Reason reason) const
+{
+  switch (reason)
+  {
+  case Reason::NO_PROGRESS:
+    return "No territory has changed hands in " + std::to_string(turnsWithoutProgress) + " turns";
+  case Reason::REPEATED_STATE:
+    return "The board is back to where it was " + (repeatedTurn == 0 ? std::string("at the start") : "after turn " + std::to_string(repeatedTurn));
+  default:
+    return "";
+  }
+}
@@ -0,0 +1,278 @@
+#include <fstream>
+#include <sstream>
+
+#include "GameState.h"
+#include "TournamentConfig.h"
+
+namespace
+{
+  std::string trim(const std::string &value)
+  {
+    const auto first = value.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+    {
+      return "";
+    }
+
+    return value.substr(first, value.find_last_not_of(" \t\r") - first + 1);
+  }
+
+  // a comma-separated list, without blanks around the items
+  bool parseList(const std::string &value, std::vector<std::string> &items)
+  {
+    std::istringstream stream(value);
+    items.clear();
+
+    for (std::string item; std::getline(stream, item, ',');)
+    {
+      item = trim(item);
+      if (item.empty())
+      {
+        return false;
+      }
+      items.push_back(item);
+    }
+
+    return !items.empty();
+  }
+
+  template <typename Integer>
+  bool parseNumber(const std::string &value, Integer &number)
+  {
+    std::istringstream stream(value);
+    stream >> number;
+
+    return !stream.fail() && stream.eof() && !value.empty() && value[0] != '-';
+  }
+
+  // "min-max"
+  bool parseRange(const std::string &value, int &min, int &max)
+  {
+    const auto dash = value.find('-');
+    int parsedMin, parsedMax;
+
+    if (dash == std::string::npos || !parseNumber(value.substr(0, dash), parsedMin) ||
+        !parseNumber(value.substr(dash + 1), parsedMax) || parsedMin > parsedMax)
+    {
+      return false;
+    }
+
+    min = parsedMin;
+    max = parsedMax;
+    return true;
+  }
+
+  bool checkCount(const char *name, const char *key, int count, int min, int max, std::string &error)
+  {
+    if (count >= min && count <= max)
+    {
+      return true;
+    }
+
+    error = std::string(name) + " is " + std::to_string(count) + ", must be between " + std::to_string(min) + " and " +
+            std::to_string(max) + " (see " + key + "-range)";
+    return false;
+  }
+} // namespace
+
+bool TournamentConfig::set(const std::string &key, const std::string &value, std::string &error)
+{
+  bool valid;
+
+  if (key == "M")
+  {
+    valid = parseList(value, maps);
+  }
+  else if (key == "P")
+  {
+    valid = parseList(value, players);
+  }
+  else if (key == "G")
+  {
+    valid = parseNumber(value, numGames);
+  }
+  else if (key == "D")
+  {
+    valid = parseNumber(value, numTurns);
+  }
+  else if (key == "seed")
+  {
+    valid = hasSeed = parseNumber(value, seed);
+  }
+  else if (key == "output")
+  {
+    valid = !value.empty();
+    outputPath = value;
+  }
+  else if (key == "threads")
+  {
+    valid = parseNumber(value, threads);
+  }
+  else if (key == "processes")
+  {
+    valid = parseNumber(value, processes) && processes > 0;
+  }
+  else if (key == "results")
+  {
+    valid = !value.empty();
+    resultsDirectory = value;
+  }
+  else if (key == "shard")
+  {
+    const auto slash = value.find('/');
+    valid = slash != std::string::npos && parseNumber(value.substr(0, slash), shard) &&
+            parseNumber(value.substr(slash + 1), shardCount) && shard >= 1 && shard <= shardCount;
+  }
+  else if (key == "quiet")
+  {
+    valid = value == "true" || value == "false";
+    quiet = value == "true";
+  }
+  else if (key == "gamelog")
+  {
+    valid = value == "true" || value == "false";
+    gameLog = value == "true";
+  }
+  else if (key == "stalemate")
+  {
+    valid = parseNumber(value, stalemate.window);
+  }
+  else if (key == "repeats")
+  {
+    valid = value == "true" || value == "false";
+    stalemate.repeatedState = value == "true";
+  }
+  else if (key == "stalemate-result")
+  {
+    // a table cell, and a field of the shard files
+    valid = !value.empty() && value.find('\t') == std::string::npos;
+    stalemate.result = value;
+  }
+  else if (key == "maps-range")
+  {
+    valid = parseRange(value, limits.minMaps, limits.maxMaps);
+  }
+  else if (key == "players-range")
+  {
+    valid = parseRange(value, limits.minPlayers, limits.maxPlayers);
+  }
+  else if (key == "games-range")
+  {
+    valid = parseRange(value, limits.minGames, limits.maxGames);
+  }
+  else if (key == "turns-range")
+  {
+    valid = parseRange(value, limits.minTurns, limits.maxTurns);
+  }
+  else
+  {
+    error = "unknown setting \"" + key + "\"";
+    return false;
+  }
+
+  if (!valid)
+  {
+    error = "invalid value \"" + value + "\" for " + key;
+  }
+
+  return valid;
+}
+
+bool TournamentConfig::loadFile(const std::string &path, std::string &error)
+{
+  std::ifstream file(path);
+  if (!file.is_open())
+  {
+    error = "can't open " + path;
+    return false;
+  }
+
+  int lineNumber = 0;
+  for (std::string line; std::getline(file, line);)
+  {
+    lineNumber++;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty())
+    {
+      continue;
+    }
+
+    const auto equals = line.find('=');
+    if (equals == std::string::npos)
+    {
+      error = path + ":" + std::to_string(lineNumber) + ": expected <key> = <value>";
+      return false;
+    }
+
+    if (!set(trim(line.substr(0, equals)), trim(line.substr(equals + 1)), error))
+    {
+      error = path + ":" + std::to_string(lineNumber) + ": " + error;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TournamentConfig::parseArguments(const std::vector<std::string> &arguments, std::string &error)
+{
+  // the file first, so the other arguments override it
+  for (size_t i = 0; i + 1 < arguments.size(); i++)
+  {
+    if (arguments[i] == "-config" && !loadFile(arguments[i + 1], error))
+    {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < arguments.size(); i++)
+  {
+    if (arguments[i] == "-tournament")
+    {
+      continue;
+    }
+
+    if (arguments[i].size() < 2 || arguments[i][0] != '-' || i + 1 >= arguments.size())
+    {
+      error = "expected -<key> <value>, got \"" + arguments[i] + "\"";
+      return false;
+    }
+
+    const auto key = arguments[i].substr(1);
+    const auto &value = arguments[++i];
+
+    if (key != "config" && !set(key, value, error))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TournamentConfig::validate(std::string &error) const
+{
+  if (maps.empty() || players.empty() || numGames == 0 || numTurns == 0)
+  {
+    error = "M, P, G and D are required";
+    return false;
+  }
+
+  if (players.size() > GameState::MAX_PLAYERS)
+  {
+    error = "P is " + std::to_string(players.size()) + ", a game can't have more than " + std::to_string(GameState::MAX_PLAYERS) + " players";
+    return false;
+  }
+
+  if (shardCount > 0 && !hasSeed)
+  {
+    // a fresh seed would play another tournament, which the other shards' results don't belong to
+    error = "shard needs the tournament's seed (the S: line of its log or shard files)";
+    return false;
+  }
+
+  return checkCount("M", "maps", maps.size(), limits.minMaps, limits.maxMaps, error) &&
+         checkCount("P", "players", players.size(), limits.minPlayers, limits.maxPlayers, error) &&
+         checkCount("G", "games", numGames, limits.minGames, limits.maxGames, error) &&
+         checkCount("D", "turns", numTurns, limits.minTurns, limits.maxTurns, error);
+}
@@ -0,0 +1,282 @@
+#include <filesystem>
+#include <fstream>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "GameEngine.h"
+
+/*
+  Tournaments split over processes.
+
+  Shard k of N plays the games whose index (map index * games per map + game
+  index) is k modulo N, each with the seed it would get in a single process,
+  and writes their results to its own file in the results directory. Shards
+  share nothing, so any of them can run (or run again) on its own, and merging
+  the files gives the table a single process would have printed.
+
+  A shard file is written once the shard is done (next to it, then renamed),
+  so a crashed shard leaves no file behind and the merge reports it missing.
+*/
+
+namespace
+{
+  const std::string SHARD_FILE_VERSION = "RISKTOURNAMENTSHARD 1";
+
+  // e.g. "results/shard-2-of-4.txt" for the second of 4 shards
+  std::string getShardPath(const std::string &directory, size_t shard, size_t shardCount, const std::string &extension)
+  {
+    const std::string name = "shard-" + std::to_string(shard + 1) + "-of-" + std::to_string(shardCount) + extension;
+    return (std::filesystem::path(directory) / name).string();
+  }
+
+  // the value after the first tab of a "key\tvalue" line, if the key matches
+  bool readField(const std::string &line, const std::string &key, std::string &value)
+  {
+    if (line.compare(0, key.size() + 1, key + "\t") != 0)
+    {
+      return false;
+    }
+
+    value = line.substr(key.size() + 1);
+    return true;
+  }
+} // namespace
+
+bool GameEngine::runTournamentShard(std::vector<std::string> mapList, std::vector<std::string> playerList, int numGames, int numTurns, uint64_t seed,
+                                    size_t shard, size_t shardCount, const std::string &resultsDirectory, size_t threadCount)
+{
+  std::vector<shared_ptr<Map>> maps;
+  std::vector<std::string> mapPaths;
+  std::string mapsLine, playersLine;
+
+  if (shardCount == 0 || shard >= shardCount || !loadTournament(mapList, playerList, maps, mapPaths, mapsLine, playersLine))
+  {
+    return false;
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(resultsDirectory, error);
+
+  const auto resultsPath = getShardPath(resultsDirectory, shard, shardCount, ".txt");
+  const auto temporaryPath = resultsPath + ".tmp";
+
+  // the games' output goes to the shard's own log, next to its results
+  std::ofstream results(temporaryPath, std::ios::trunc);
+  std::ofstream output(getShardPath(resultsDirectory, shard, shardCount, ".log"), std::ios::trunc);
+
+  if (!results.is_open() || !output.is_open())
+  {
+    std::cout << "Can't write the results of shard " << shard + 1 << " of " << shardCount << " to " << resultsDirectory << std::endl;
+    return false;
+  }
+
+  // the header identifies the tournament, so the merge can check every shard played the same one
+  results << SHARD_FILE_VERSION << '\n'
+          << "shard\t" << shard + 1 << '\t' << shardCount << '\n'
+          << "games\t" << numGames << '\n';
+
+  std::istringstream header(formatTournamentHeader(mapsLine, playersLine, numGames, numTurns, seed, stalemate));
+  for (std::string line; std::getline(header, line);)
+  {
+    results << "header\t" << line << '\n';
+  }
+
+  for (auto &&map : maps)
+  {
+    results << "map\t" << map->getImage() << '\n';
+  }
+
+  std::vector<size_t> games;
+  for (size_t game = shard; game < maps.size() * numGames; game += shardCount)
+  {
+    games.push_back(game);
+  }
+
+  std::cout << "Playing shard " << shard + 1 << " of " << shardCount << ": " << games.size() << " games" << std::endl;
+
+  playTournamentGames(maps, mapPaths, playerList, numGames, numTurns, seed, games, threadCount, true, quiet, gameLog, stalemate,
+                      [&](size_t game, const std::string &result, const std::string &gameOutput)
+                      {
+                        output << gameOutput;
+                        results << "result\t" << game << '\t' << result << '\n';
+                      });
+
+  results.close();
+  if (!results)
+  {
+    return false;
+  }
+
+  std::filesystem::rename(temporaryPath, resultsPath, error);
+  return !error;
+}
+
+size_t GameEngine::mergeTournamentShards(std::vector<std::string> mapList, std::vector<std::string> playerList, int numGames, int numTurns, uint64_t seed,
+                                         size_t shardCount, const std::string &resultsDirectory)
+{
+  std::vector<shared_ptr<Map>> maps;
+  std::vector<std::string> mapPaths;
+  std::string mapsLine, playersLine;
+
+  if (!loadTournament(mapList, playerList, maps, mapPaths, mapsLine, playersLine))
+  {
+    return shardCount;
+  }
+
+  // the tournament asked for, not whichever shard file reads first: files left over from another one don't count
+  const std::string header = formatTournamentHeader(mapsLine, playersLine, numGames, numTurns, seed, stalemate);
+  std::vector<std::string> images;
+  for (auto &&map : maps)
+  {
+    images.push_back(map->getImage());
+  }
+
+  std::vector<std::string> results(images.size() * numGames, "Missing");
+  size_t missingShards = 0;
+
+  for (size_t shard = 0; shard < shardCount; shard++)
+  {
+    const auto path = getShardPath(resultsDirectory, shard, shardCount, ".txt");
+    std::ifstream file(path);
+    std::string line, value;
+
+    std::string shardHeader;
+    std::vector<std::string> shardImages;
+    std::vector<std::pair<size_t, std::string>> shardResults;
+    int shardGames = 0;
+    bool valid = std::getline(file, line) && line == SHARD_FILE_VERSION;
+
+    while (valid && std::getline(file, line))
+    {
+      if (readField(line, "header", value))
+      {
+        shardHeader += (shardHeader.empty() ? "" : "\n") + value;
+      }
+      else if (readField(line, "map", value))
+      {
+        shardImages.push_back(value);
+      }
+      else if (readField(line, "games", value))
+      {
+        shardGames = std::atoi(value.c_str());
+      }
+      else if (readField(line, "result", value))
+      {
+        const auto tab = value.find('\t');
+        valid = tab != std::string::npos && tab > 0;
+        if (valid)
+        {
+          shardResults.emplace_back(std::strtoull(value.c_str(), nullptr, 10), value.substr(tab + 1));
+        }
+      }
+    }
+
+    valid = valid && shardHeader == header && shardImages == images && shardGames == numGames;
+    for (auto &&[game, result] : shardResults)
+    {
+      valid = valid && game < results.size() && game % shardCount == shard;
+    }
+
+    // all of a shard's results or none of them
+    for (auto &&[game, result] : shardResults)
+    {
+      if (valid)
+      {
+        results[game] = result;
+      }
+    }
+
+    if (!valid)
+    {
+      std::cout << "Shard " << shard + 1 << " of " << shardCount << " is missing (or isn't from this tournament): " << path
+                << "; its games show as Missing until it's run again" << std::endl;
+      missingShards++;
+    }
+  }
+
+  this->isTournament = true;
+  this->tournament_log = formatTournamentLog(header, images, results, numGames, images.size());
+  std::cout << tournament_log << std::endl;
+  Notify(this);
+
+  return missingShards;
+}
+
+size_t GameEngine::startShardedTournament(std::vector<std::string> mapList, std::vector<std::string> playerList, int numGames, int numTurns, uint64_t seed,
+                                          size_t processCount, const std::string &resultsDirectory, size_t threadsPerProcess)
+{
+  // checked once up front, which also compiles the maps the shards load
+  std::vector<shared_ptr<Map>> maps;
+  std::vector<std::string> mapPaths;
+  std::string mapsLine, playersLine;
+
+  processCount = std::max<size_t>(1, processCount);
+  if (!loadTournament(mapList, playerList, maps, mapPaths, mapsLine, playersLine))
+  {
+    return processCount;
+  }
+
+  if (threadsPerProcess == 0)
+  {
+    threadsPerProcess = std::max<size_t>(1, std::thread::hardware_concurrency() / processCount);
+  }
+
+  // a shard that fails leaves no file behind, rather than the one of an earlier tournament
+  for (size_t shard = 0; shard < processCount; shard++)
+  {
+    std::error_code error;
+    std::filesystem::remove(getShardPath(resultsDirectory, shard, processCount, ".txt"), error);
+  }
+
+  // anything still buffered would otherwise be written again by every child
+  std::cout.flush();
+
+  std::vector<pid_t> workers(processCount, -1);
+  for (size_t shard = 0; shard < processCount; shard++)
+  {
+    workers[shard] = fork();
+
+    if (workers[shard] == 0)
+    {
+      // the child plays its shard, then leaves without running the parent's destructors
+      bool played = false;
+      try
+      {
+        played = runTournamentShard(mapList, playerList, numGames, numTurns, seed, shard, processCount, resultsDirectory, threadsPerProcess);
+      }
+      catch (const std::exception &exception)
+      {
+        std::cout << "Shard " << shard + 1 << " failed: " << exception.what() << std::endl;
+      }
+
+      std::cout.flush();
+      _exit(played ? 0 : 1);
+    }
+
+    if (workers[shard] < 0)
+    {
+      std::cout << "Can't start the process of shard " << shard + 1 << " of " << processCount << std::endl;
+    }
+  }
+
+  for (size_t shard = 0; shard < processCount; shard++)
+  {
+    int status = 0;
+    if (workers[shard] < 0 || waitpid(workers[shard], &status, 0) < 0)
+    {
+      continue;
+    }
+
+    if (WIFSIGNALED(status))
+    {
+      std::cout << "Shard " << shard + 1 << " of " << processCount << " crashed (signal " << WTERMSIG(status) << ")" << std::endl;
+    }
+    else if (WEXITSTATUS(status) != 0)
+    {
+      std::cout << "Shard " << shard + 1 << " of " << processCount << " failed (exit status " << WEXITSTATUS(status) << ")" << std::endl;
+    }
+  }
+
+  return mergeTournamentShards(mapList, playerList, numGames, numTurns, seed, processCount, resultsDirectory);
+}
@@ -1,3 +1,5 @@
+#include <mutex>
+
 #include "LoggingObserver.h"
 
 // Created by Maxime Landry (maxime334).
@@ -82,6 +84,11 @@ LogObserver::LogObserver(Subject &s) : Observer(s) {}
 
 void LogObserver::Update(ILoggable &ilog) const
 {
+  // Games of a tournament play (and log) on several threads at once.
+  // One entry is appended at a time, so entries never interleave.
+  static std::mutex file_mutex;
+  std::lock_guard<std::mutex> lock(file_mutex);
+
   std::ofstream ofs;
   // Appends to the file.
   ofs.open(obs::path, std::ios::app); // Ready to append.
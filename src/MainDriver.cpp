@@ -1,3 +1,4 @@
+#include <charconv>
 #include <iostream>
 
 #include "Cards.h"
@@ -6,12 +7,23 @@
 #include "GameEngine.h"
 #include "LoggingObserver.h"
 #include "Map.h"
+#include "MapGenerator.h"
 #include "Orders.h"
 #include "Player.h"
 #include "PlayerStrategies.h"
 
 void game() { std::cout << "Welcome to Warzone!" << std::endl; }
 
+// a whole argument as a non-negative integer, false if it's anything else
+template <typename Integer>
+static bool parseArgument(const std::string &argument, Integer &number)
+{
+  const auto end = argument.data() + argument.size();
+  const auto result = std::from_chars(argument.data(), end, number);
+
+  return !argument.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
 int main(int argc, char const *argv[])
 {
   // Using obs::path, path to the gamelog file.
@@ -23,6 +35,66 @@ int main(int argc, char const *argv[])
   std::vector<std::string> argsVector = std::vector<std::string>(
       argv + 1, argv + argc); // create a vector of the command line arguments
 
+  // if the '-generate' flag is provided, write a synthetic map and exit
+  // usage: -generate <grid|ring|geometric|scalefree> <territories> <continents> <seed> <path>
+  const auto generateIterator =
+      std::find(argsVector.begin(), argsVector.end(), "-generate");
+  if (generateIterator != argsVector.end())
+  {
+    MapGeneratorOptions options;
+
+    if (argsVector.end() - generateIterator < 6 ||
+        !MapGenerator::getFamilyFromString(*(generateIterator + 1), options.family) ||
+        !parseArgument(*(generateIterator + 2), options.territoryCount) ||
+        !parseArgument(*(generateIterator + 3), options.continentCount) ||
+        !parseArgument(*(generateIterator + 4), options.seed))
+    {
+      std::cout << "Usage: -generate <grid|ring|geometric|scalefree> "
+                   "<territories> <continents> <seed> <path>"
+                << std::endl;
+      return 1;
+    }
+
+    const auto map = MapGenerator::generate(options);
+    if (!MapWriter::writeMap(*map, *(generateIterator + 5)))
+      return 1;
+
+    std::cout << "Generated " << options.family << " map: "
+              << map->getTerritoryCount() << " territories, "
+              << map->getContinentCount() << " continents ("
+              << map->getValidity() << ")" << std::endl;
+
+    return 0;
+  }
+
+  // if the '-tournament' flag is provided, run a tournament from the other
+  // arguments and/or a config file (see TournamentConfig) and exit
+  // usage: -tournament [-config <path>] -M <maps> -P <players> -G <games> -D <turns>
+  //        [-seed <seed>] [-output <path>] [-threads <n>] [-processes <n>] ...
+  if (std::find(argsVector.begin(), argsVector.end(), "-tournament") != argsVector.end())
+  {
+    TournamentConfig config;
+    std::string error;
+
+    if (!config.parseArguments(argsVector, error))
+    {
+      std::cout << "Invalid tournament arguments: " << error << std::endl;
+      std::cout << "Usage: -tournament [-config <path>] -M <maps> -P <players> "
+                   "-G <games> -D <turns> [-seed <seed>] [-output <path>] "
+                   "[-threads <n>] [-processes <n>] [-results <directory>] "
+                   "[-shard <k>/<n>] [-maps-range <min>-<max>] "
+                   "[-players-range <min>-<max>] [-games-range <min>-<max>] "
+                   "[-turns-range <min>-<max>] [-quiet <true|false>] [-gamelog <true|false>] "
+                   "[-stalemate <turns>] [-repeats <true|false>] "
+                   "[-stalemate-result <text>]"
+                << std::endl;
+      return 1;
+    }
+
+    GameEngine engine;
+    return engine.runTournament(config);
+  }
+
   const auto testRunIterator =
       std::find(argsVector.begin(), argsVector.end(), "-test");
 
@@ -41,7 +113,7 @@ int main(int argc, char const *argv[])
     std::cout << "Choose your poison \n1: Test Maps\n2: Test Players\n3: Test "
                  "Orders\n4: Test Cards\n5: Test Game Engine\n6: Test Command "
                  "Processor\n7: Test Startup Phase\n8: Test Main Game Loop "
-                 "\n9: Test Logging Observer\n10: Test Player Strategies\n11: Test Tournament\nElse: exit\n";
+                 "\n9: Test Logging Observer\n10: Test Player Strategies\n11: Test Tournament\n12: Benchmark Maps\n13: Benchmark Players\n14: Benchmark Tournament\n15: Test Sharded Tournament\n16: Benchmark Output Sinks\nElse: exit\n";
     std::cin >> choice;
     std::cin.ignore(1000, '\n');
     std::cout << std::endl;
@@ -109,6 +181,21 @@ int main(int argc, char const *argv[])
     case 11:
       testTournament();
       break;
+    case 12:
+      benchmarkMaps();
+      break;
+    case 13:
+      benchmarkPlayers();
+      break;
+    case 14:
+      benchmarkTournament();
+      break;
+    case 15:
+      testShardedTournament();
+      break;
+    case 16:
+      benchmarkOutputSinks();
+      break;
     default:
       std::cout << "Byyyye ;)" << std::endl;
       return 0;
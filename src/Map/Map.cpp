@@ -1,7 +1,10 @@
+#include <algorithm>
+#include <bitset>
+#include <charconv>
 #include <fstream>
 
 #include "Map.h"
-#include "Player.h"
+#include "ThreadPool.h"
 
 std::ostream &operator<<(std::ostream &os, const MapValidity &validity)
 {
@@ -44,10 +47,10 @@ std::ostream &operator<<(std::ostream &os, const ScrollDirection &direction)
 }
 
 // remove leading & trailing whitespace (https://stackoverflow.com/a/1798170)
-std::string trim(const std::string &str, const std::string &whitespace)
+static std::string_view trim(std::string_view str, std::string_view whitespace = " \t\r\n")
 {
     const auto strBegin = str.find_first_not_of(whitespace);
-    if (strBegin == std::string::npos)
+    if (strBegin == std::string_view::npos)
         return ""; // no content
 
     const auto strEnd = str.find_last_not_of(whitespace);
@@ -56,7 +59,37 @@ std::string trim(const std::string &str, const std::string &whitespace)
     return str.substr(strBegin, strRange);
 }
 
-ScrollDirection getScrollDirectionFromString(const std::string &scrollDirectionString)
+// parses a base-10 integer like std::stoi does (leading whitespace skipped, trailing characters ignored), without throwing
+static bool parseInteger(std::string_view field, int &value)
+{
+    const auto numberBegin = field.find_first_not_of(" \t\r\n\v\f");
+    if (numberBegin == std::string_view::npos)
+        return false;
+
+    field.remove_prefix(numberBegin);
+    if (field.front() == '+')
+        field.remove_prefix(1);
+
+    return std::from_chars(field.data(), field.data() + field.size(), value).ec == std::errc();
+}
+
+// splits "name=value" on the last '=' that leaves both sides non-empty (what the "(^.+)=(.+)" pattern used to capture)
+static bool splitField(std::string_view line, std::string_view &name, std::string_view &value)
+{
+    for (auto i = line.size() < 2 ? 0 : line.size() - 2; i > 0; i--)
+    {
+        if (line[i] == '=')
+        {
+            name = line.substr(0, i);
+            value = line.substr(i + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static ScrollDirection getScrollDirectionFromString(std::string_view scrollDirectionString)
 {
     if (scrollDirectionString == "horizontal")
         return ScrollDirection::HORIZONTAL;
@@ -66,23 +99,27 @@ ScrollDirection getScrollDirectionFromString(const std::string &scrollDirectionS
         return ScrollDirection::NONE;
 }
 
-bool getBooleanFromString(const std::string &booleanString)
+static bool getBooleanFromString(std::string_view booleanString)
 {
     return booleanString == "yes" || booleanString == "true" || booleanString == "1";
 }
 
-std::string getStringFromBoolean(const bool &boolean)
+static std::string getStringFromBoolean(const bool &boolean)
 {
     return boolean ? "True" : "False";
 }
 
-std::shared_ptr<Map> MapLoader::loadMap(const std::string &path)
+std::shared_ptr<Map> MapLoader::loadMap(const std::string &path, uint64_t *hash)
 {
-    std::string line;
-    std::ifstream mapFile(path);
+    std::ifstream mapFile(path, std::ios::binary);
     int8_t mapSection = -1;
+    bool lineProcessed = true;
 
     std::shared_ptr<Map> map = std::make_shared<Map>();
+    ParseState state;
+
+    if (hash != nullptr)
+        *hash = 0;
 
     if (!mapFile.is_open())
     {
@@ -91,12 +128,33 @@ std::shared_ptr<Map> MapLoader::loadMap(const std::string &path)
         return map;
     }
 
-    while (std::getline(mapFile, line))
+    // the whole file is read in one go, then tokenized in place
+    mapFile.seekg(0, std::ios::end);
+    std::string buffer(static_cast<size_t>(mapFile.tellg()), '\0');
+    mapFile.seekg(0, std::ios::beg);
+    mapFile.read(buffer.data(), buffer.size());
+    buffer.resize(static_cast<size_t>(mapFile.gcount())); // in case the file shrank in the meantime
+
+    // an empty file hashes to 0, like hashMapFile
+    if (hash != nullptr && !buffer.empty())
+        *hash = hashBytes(buffer.data(), buffer.size());
+
+    std::string_view remaining = buffer;
+
+    // every line could declare a territory, so this bounds the name index and spares it from rehashing while loading
+    const auto lineCount = static_cast<size_t>(std::count(buffer.begin(), buffer.end(), '\n')) + 1;
+    map->territoryIds.reserve(lineCount);
+    map->territoriesById.reserve(lineCount);
+    state.adjacencyNameOffsets.reserve(lineCount + 1);
+
+    while (lineProcessed && !remaining.empty())
     {
-        if (line.empty() || line == "\r" || line == "\n" || line == "\r\n")
-            continue; // skip empty lines
+        const auto lineEnd = remaining.find('\n');
+        const auto line = trim(remaining.substr(0, lineEnd));
+        remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
 
-        line = trim(line);
+        if (line.empty())
+            continue; // skip empty (or whitespace-only) lines
 
         int8_t tempSection = getMapSection(line); // 0: Map, 1: Continents, 2: Territories
 
@@ -110,121 +168,293 @@ std::shared_ptr<Map> MapLoader::loadMap(const std::string &path)
         switch (mapSection)
         {
         case 0:
-            if (!processMapLine(line, map))
-                return map;
+            lineProcessed = processMapLine(line, map);
             break;
 
         case 1:
-            if (!processContinentsLine(line, map))
-                return map;
+            lineProcessed = processContinentsLine(line, map);
             break;
 
         case 2:
-            if (!processTerritoriesLine(line, map))
-                return map;
+            lineProcessed = processTerritoriesLine(line, map, state);
             break;
         }
     }
 
+    // the adjacency and the indexes over it are built even for partially loaded maps, so queries on them stay well-defined
+    buildAdjacency(map, state);
+    map->buildIndexes();
+
     return map;
 }
 
-uint8_t MapLoader::getMapSection(const std::string &line)
+void MapLoader::parseMapHeader(std::string_view contents, MapHeader &header, uint64_t *hash)
+{
+    int8_t mapSection = -1;
+    bool mapSectionRead = false;
+    uint64_t contentHash = hashBytes(nullptr, 0);
+
+    std::string_view remaining = contents;
+
+    // only [Map] lines are parsed, lines of the other sections are just counted
+    while (!remaining.empty())
+    {
+        const auto lineEnd = remaining.find('\n');
+        const auto lineLength = lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1;
+
+        // the whole file goes through the hash, line breaks and blank lines included
+        if (hash != nullptr)
+            contentHash = hashBytes(remaining.data(), lineLength, contentHash);
+
+        const auto line = trim(remaining.substr(0, lineEnd));
+        remaining.remove_prefix(lineLength);
+
+        if (line.empty())
+            continue;
+
+        const auto tempSection = getMapSection(line);
+
+        if (tempSection != -1 && tempSection != mapSection)
+        {
+            mapSectionRead = mapSectionRead || mapSection == 0;
+            mapSection = tempSection;
+            continue;
+        }
+
+        std::string_view field, value;
+
+        switch (mapSection)
+        {
+        case 0:
+            // a [Map] section repeated further down isn't read
+            if (mapSectionRead || !splitField(line, field, value))
+                break;
+
+            if (field == "author")
+                header.author = value;
+            else if (field == "image")
+                header.image = value;
+            else if (field == "scroll")
+                header.scroll = getScrollDirectionFromString(value);
+            else if (field == "wrap")
+                header.wrap = getBooleanFromString(value);
+            else if (field == "warn")
+                header.warn = getBooleanFromString(value);
+            break;
+
+        case 1:
+            header.continentCount++;
+            break;
+
+        case 2:
+            header.territoryCount++;
+            break;
+        }
+    }
+
+    if (hash != nullptr)
+        *hash = contentHash;
+}
+
+std::vector<std::shared_ptr<Map>> MapLoader::loadMapsCached(const std::vector<std::string> &paths, ThreadPool &pool)
 {
-    std::smatch match;
-    std::regex_search(line, match, HEADER_PATTERN);
+    std::vector<std::shared_ptr<Map>> maps(paths.size());
+    std::vector<std::future<void>> loads;
+    loads.reserve(paths.size());
 
-    if (match.size() != 2)
-        return -1; // invalid line, not enough matches (or too many matches)
+    // index of the first map found invalid so far; maps after it that haven't started are cancelled
+    std::atomic<size_t> firstInvalid{paths.size()};
 
-    if (match[1].str() == "Map")
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        loads.push_back(pool.submit([&, i]()
+                                    {
+            if (i > firstInvalid.load(std::memory_order_acquire))
+                return;
+
+            maps[i] = MapLoader::loadMapCached(paths[i]);
+
+            if (maps[i]->getValidity() == MapValidity::VALID)
+                return;
+
+            // keep the lowest invalid index, as an earlier map may turn out invalid after a later one
+            auto invalid = firstInvalid.load(std::memory_order_relaxed);
+            while (i < invalid && !firstInvalid.compare_exchange_weak(invalid, i, std::memory_order_acq_rel))
+            {
+            } }));
+    }
+
+    for (auto &&load : loads)
+        load.get();
+
+    return maps;
+}
+
+int8_t MapLoader::getMapSection(std::string_view line)
+{
+    // a header is whatever sits between the first '[' and the last ']' (e.g. "[Map]", without the brackets)
+    const auto headerBegin = line.find('[');
+    const auto headerEnd = line.rfind(']');
+
+    if (headerBegin == std::string_view::npos || headerEnd == std::string_view::npos || headerEnd < headerBegin + 2)
+        return -1; // not a header line
+
+    const auto header = line.substr(headerBegin + 1, headerEnd - headerBegin - 1);
+
+    if (header == "Map")
         return 0;
-    else if (match[1].str() == "Continents")
+    else if (header == "Continents")
         return 1;
-    else if (match[1].str() == "Territories")
+    else if (header == "Territories")
         return 2;
     else
         return -1; // Invalid section
 }
 
-bool MapLoader::processMapLine(const std::string &line, const std::shared_ptr<Map> &map)
+bool MapLoader::processMapLine(std::string_view line, const std::shared_ptr<Map> &map)
 {
-    std::smatch match;
-    std::regex_search(line, match, FIELD_PATTERN);
+    std::string_view field, value;
 
-    if (match.size() != 3)
-        return false; // invalid line, not enough matches (or too many matches)
+    if (!splitField(line, field, value))
+        return false; // invalid line, not a "field=value" pair
 
-    if (match[1].str() == "author")
-        *map->author = match[2].str();
+    if (field == "author")
+        *map->author = value;
 
-    if (match[1].str() == "image")
-        *map->image = match[2].str();
+    if (field == "image")
+        *map->image = value;
 
-    if (match[1].str() == "scroll")
-        *map->scroll = getScrollDirectionFromString(match[2].str());
+    if (field == "scroll")
+        *map->scroll = getScrollDirectionFromString(value);
 
-    if (match[1].str() == "wrap")
-        *map->wrap = getBooleanFromString(match[2].str());
+    if (field == "wrap")
+        *map->wrap = getBooleanFromString(value);
 
-    if (match[1].str() == "warn")
-        *map->warn = getBooleanFromString(match[2].str());
+    if (field == "warn")
+        *map->warn = getBooleanFromString(value);
 
     return true;
 }
 
-bool MapLoader::processContinentsLine(const std::string &line, const std::shared_ptr<Map> &map)
+bool MapLoader::processContinentsLine(std::string_view line, const std::shared_ptr<Map> &map)
 {
-    std::shared_ptr<Continent> continent = std::make_shared<Continent>();
-    std::smatch match;
-    std::regex_search(line, match, FIELD_PATTERN);
+    std::string_view name, bonusField;
+    int bonus = 0;
 
-    if (match.size() != 3)
-        return false; // invalid line, not enough matches (or too many matches)
+    if (!splitField(line, name, bonusField) || !parseInteger(bonusField, bonus))
+        return false; // invalid line, not a "name=bonus" pair
 
-    *continent->name = trim(match[1].str());
-    *continent->bonus = std::stoi(match[2].str());
+    name = trim(name);
 
-    map->continents.emplace(*continent->name, continent);
+    // a continent declared twice keeps its first definition (addContinent rejects the duplicate)
+    map->addContinent(name, bonus);
 
     return true;
 }
 
-bool MapLoader::processTerritoriesLine(const std::string &line, const std::shared_ptr<Map> &map)
+bool MapLoader::processTerritoriesLine(std::string_view line, const std::shared_ptr<Map> &map, ParseState &state)
 {
-    std::shared_ptr<Territory> territory = std::make_shared<Territory>();
-    std::vector<std::string> allMatches;
-    std::string currentLine = line;
-    std::smatch match;
+    std::string_view fields[4]; // name, x, y, continent; every following field is a neighbour
+    size_t fieldCount = 0;
+    const auto firstNeighbour = state.adjacencyNames.size();
 
-    // gets all matches of the comma-separated pattern
-    while (std::regex_search(currentLine, match, COMMA_SEPARATED_PATTERN))
+    // splits the line on commas in a single pass, skipping empty fields (like the "([^,]+)+" pattern used to)
+    for (size_t fieldBegin = 0; fieldBegin <= line.size();)
     {
-        allMatches.push_back(trim(match[1].str()));
-        currentLine = match.suffix().str(); // update the line to search, because regex_search() only searches until the first find
-    }
+        auto fieldEnd = line.find(',', fieldBegin);
+        if (fieldEnd == std::string_view::npos)
+            fieldEnd = line.size();
 
-    if (allMatches.size() < 5)
-        return false; // invalid line, not enough matches
+        if (fieldEnd > fieldBegin)
+        {
+            const auto field = trim(line.substr(fieldBegin, fieldEnd - fieldBegin));
 
-    *territory->name = trim(allMatches[0]);
-    *territory->x = std::stoi(allMatches[1]);
-    *territory->y = std::stoi(allMatches[2]);
-    const auto continentName = trim(allMatches[3]);
+            if (fieldCount < 4)
+                fields[fieldCount] = field;
+            else
+                state.adjacencyNames.push_back(field);
 
-    // add adjacent territories, to the adjacency map (key: territory name, value: vector of adjacent territory names), to be associated with the territory later
-    map->adjacency.emplace(*territory->name, std::vector<std::string>(allMatches.begin() + 4, allMatches.end()));
+            fieldCount++;
+        }
 
-    // associate the territory with its continent
-    territory->continent = map->continents[continentName];
-    (*territory->continent->territoryCount)++;
+        fieldBegin = fieldEnd + 1;
+    }
 
-    // update related data structures (map's unordered map of territories)
-    map->territories.emplace(*territory->name, territory);
+    int x = 0, y = 0;
+
+    if (fieldCount < 5 || !parseInteger(fields[1], x) || !parseInteger(fields[2], y))
+    {
+        state.adjacencyNames.resize(firstNeighbour);
+        return false; // invalid line, not enough fields (or bad coordinates)
+    }
+
+    // a territory must belong to a declared continent, and its name must be unique
+    const auto continentIterator = map->continentIds.find(fields[3]);
+    if (continentIterator == map->continentIds.end() || map->addTerritory(fields[0], x, y, continentIterator->second) == INVALID_TERRITORY_ID)
+    {
+        state.adjacencyNames.resize(firstNeighbour);
+        *(map->validity) = MapValidity::INVALID;
+        return false;
+    }
+
+    // the neighbour names stay as views into the file buffer (indexed by territory ID) until all territories are loaded
+    state.adjacencyNameOffsets.push_back(static_cast<uint32_t>(state.adjacencyNames.size()));
 
     return true;
 }
 
+void MapLoader::buildAdjacency(const std::shared_ptr<Map> &map, const ParseState &state)
+{
+    // neighbours are resolved through an open-addressing table over views of the territories' own names (power of two, at most half full)
+    const auto territoryCount = map->territoriesById.size();
+    size_t capacity = 2;
+    while (capacity < territoryCount * 2)
+        capacity *= 2;
+
+    std::vector<std::string_view> names(territoryCount);
+    std::vector<TerritoryId> slots(capacity, INVALID_TERRITORY_ID);
+    const std::hash<std::string_view> hash;
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+    {
+        names[territory] = map->territoriesById[territory].name;
+
+        auto slot = hash(names[territory]) & (capacity - 1);
+        while (slots[slot] != INVALID_TERRITORY_ID)
+            slot = (slot + 1) & (capacity - 1);
+
+        slots[slot] = territory;
+    }
+
+    map->adjacencyOffsets.assign(1, 0);
+    map->adjacencyOffsets.reserve(territoryCount + 1);
+    map->adjacencyTargets.clear();
+    map->adjacencyTargets.reserve(state.adjacencyNames.size());
+
+    for (size_t territory = 0; territory < territoryCount; territory++)
+    {
+        for (auto i = state.adjacencyNameOffsets[territory]; i < state.adjacencyNameOffsets[territory + 1]; i++)
+        {
+            const auto &neighbourName = state.adjacencyNames[i];
+
+            auto slot = hash(neighbourName) & (capacity - 1);
+            while (slots[slot] != INVALID_TERRITORY_ID && names[slots[slot]] != neighbourName)
+                slot = (slot + 1) & (capacity - 1);
+
+            // a neighbour that was never declared can't be part of a valid map
+            if (slots[slot] == INVALID_TERRITORY_ID)
+            {
+                *(map->validity) = MapValidity::INVALID;
+                continue;
+            }
+
+            map->adjacencyTargets.push_back(slots[slot]);
+        }
+
+        map->adjacencyOffsets.push_back(static_cast<uint32_t>(map->adjacencyTargets.size()));
+    }
+}
+
 /* MAP */
 
 Map::Map()
@@ -236,11 +466,15 @@ Map::Map()
     validity = new MapValidity(MapValidity::UNKNOWN);
     warn = new bool(false);
 
-    continents = std::unordered_map<std::string, std::shared_ptr<Continent>>();
-    territories = std::unordered_map<std::string, std::shared_ptr<Territory>>();
+    names = std::make_shared<NameArena>();
+    distances = std::make_unique<DistanceCache>();
+    adjacencyOffsets = std::vector<uint32_t>(1, 0);
+    continentMemberOffsets = std::vector<uint32_t>(1, 0);
+    borderOffsets = std::vector<uint32_t>(1, 0);
+    entryPointOffsets = std::vector<uint32_t>(1, 0);
 }
 
-Map::Map(const Map &map) : continents(map.continents), territories(map.territories)
+Map::Map(const Map &map) : names(map.names), territoryIds(map.territoryIds), continentIds(map.continentIds), territoriesById(map.territoriesById), continentsById(map.continentsById), adjacencyOffsets(map.adjacencyOffsets), adjacencyTargets(map.adjacencyTargets), continentOfTerritory(map.continentOfTerritory), continentMemberOffsets(map.continentMemberOffsets), continentMembers(map.continentMembers), adjacencyMatrix(map.adjacencyMatrix), topologyFlags(map.topologyFlags), articulationPoints(map.articulationPoints), bridges(map.bridges), borderOffsets(map.borderOffsets), borderTerritories(map.borderTerritories), entryPointOffsets(map.entryPointOffsets), entryPoints(map.entryPoints), spatialIndex(map.spatialIndex), distances(std::make_unique<DistanceCache>())
 {
     author = map.author;
     image = map.image;
@@ -248,6 +482,8 @@ Map::Map(const Map &map) : continents(map.continents), territories(map.territori
     wrap = map.wrap;
     validity = map.validity;
     warn = map.warn;
+
+    bindContinents();
 }
 
 Map::~Map()
@@ -263,8 +499,28 @@ Map &Map::operator=(const Map &map)
     this->wrap = map.wrap;
     this->warn = map.warn;
     this->validity = map.validity;
-    this->continents = map.continents;
-    this->territories = map.territories;
+    this->names = map.names;
+    this->territoryIds = map.territoryIds;
+    this->continentIds = map.continentIds;
+    this->territoriesById = map.territoriesById;
+    this->continentsById = map.continentsById;
+    this->adjacencyOffsets = map.adjacencyOffsets;
+    this->adjacencyTargets = map.adjacencyTargets;
+    this->continentOfTerritory = map.continentOfTerritory;
+    this->continentMemberOffsets = map.continentMemberOffsets;
+    this->continentMembers = map.continentMembers;
+    this->adjacencyMatrix = map.adjacencyMatrix;
+    this->topologyFlags = map.topologyFlags;
+    this->articulationPoints = map.articulationPoints;
+    this->bridges = map.bridges;
+    this->borderOffsets = map.borderOffsets;
+    this->borderTerritories = map.borderTerritories;
+    this->entryPointOffsets = map.entryPointOffsets;
+    this->entryPoints = map.entryPoints;
+    this->spatialIndex = map.spatialIndex;
+    this->distances = std::make_unique<DistanceCache>();
+
+    bindContinents();
 
     return *this;
 }
@@ -272,77 +528,101 @@ Map &Map::operator=(const Map &map)
 // Map object stream insertion operator
 std::ostream &operator<<(std::ostream &os, const Map &map)
 {
-    os << "Map: { Author: " << *map.author << ", Image: " << *map.image << ", Scroll: " << *map.scroll << ", Wrap: " << getStringFromBoolean(*map.wrap) << ", Warn: " << getStringFromBoolean(*map.warn) << ", Validity: " << *map.validity << ", # of Continents: " << map.continents.size() << ", # of Territories: " << map.territories.size() << " }";
+    os << "Map: { Author: " << *map.author << ", Image: " << *map.image << ", Scroll: " << *map.scroll << ", Wrap: " << getStringFromBoolean(*map.wrap) << ", Warn: " << getStringFromBoolean(*map.warn) << ", Validity: " << *map.validity << ", # of Continents: " << map.continentsById.size() << ", # of Territories: " << map.territoriesById.size() << " }";
 
     return os;
 }
 
-SharedContinentsVector Map::getAllContinents(const Map &map)
+// continents and territories are returned in ID order, which is the order they were declared in the map file
+ContinentsVector Map::getAllContinents(const Map &map)
 {
-    SharedContinentsVector continents{};
+    ContinentsVector continents{};
+    continents.reserve(map.continentsById.size());
 
-    for (auto &&pair : map.continents)
+    for (auto &&continent : map.continentsById)
     {
-        continents.emplace_back(pair.second);
+        continents.push_back(&continent);
     }
 
     return continents;
 }
 
-SharedTerritoriesVector Map::getAllTerritories(const Map &map)
+TerritoriesVector Map::getAllTerritories(const Map &map)
 {
-    SharedTerritoriesVector territories{};
+    TerritoriesVector territories{};
+    territories.reserve(map.territoriesById.size());
 
-    for (auto &&pair : map.territories)
+    for (auto &&territory : map.territoriesById)
     {
-        territories.emplace_back(pair.second);
+        territories.push_back(&territory);
     }
 
     return territories;
 }
 
 // This function is included for convenience, works identically to its overloaded version.
-SharedTerritoriesVector Map::getAllTerritoriesInContinent(const Map &map, const Continent &continent)
+TerritoriesVector Map::getAllTerritoriesInContinent(const Map &map, const Continent &continent)
 {
-    return Map::getAllTerritoriesInContinent(map, continent.getName());
+    return Map::getAllTerritoriesInContinent(map, continent.getId());
 }
 
-SharedTerritoriesVector Map::getAllTerritoriesInContinent(const Map &map, const std::string &continent)
+TerritoriesVector Map::getAllTerritoriesInContinent(const Map &map, std::string_view continent)
 {
-    SharedTerritoriesVector territoriesInContinent{};
+    const auto continentId = Map::getContinentId(map, continent);
 
-    for (auto &&pair : map.territories)
-    {
-        if (pair.second->getContinent()->getName() == continent)
-            territoriesInContinent.emplace_back(pair.second);
-    }
+    if (continentId == INVALID_CONTINENT_ID)
+        return TerritoriesVector{};
+
+    return Map::getAllTerritoriesInContinent(map, continentId);
+}
+
+TerritoriesVector Map::getAllTerritoriesInContinent(const Map &map, ContinentId continent)
+{
+    const auto members = Map::getTerritoriesInContinent(map, continent);
 
-    return territoriesInContinent;
+    return TerritoriesVector(members.begin(), members.end());
 }
 
-bool Map::areAllTerritoriesInContinentExclusive(const Map &map, const std::string &continent, const std::vector<std::string> &territories)
+bool Map::areAllTerritoriesInContinentExclusive(const Map &map, std::string_view continent, const std::vector<std::string> &territories)
 {
-    auto territoriesTraversed = 0;
+    const auto continentId = map.continentIds.at(continent);
 
     // check if all territories are in the same continent
     for (auto &&territoryName : territories)
     {
-        if (map.territories.at(territoryName)->getContinent()->getName() != continent)
+        if (map.continentOfTerritory[map.territoryIds.at(territoryName)] != continentId)
             return false;
-
-        territoriesTraversed++;
     }
 
     // check if the continent has no other territories
-    return territoriesTraversed == map.continents.at(continent)->getTerritoryCount();
+    return territories.size() == Map::getTerritoryIdsInContinent(map, continentId).size();
 }
 
-bool Map::areAllTerritoriesInContinent(const Map &map, const std::string &continent, const std::vector<std::string> &territories)
+bool Map::areAllTerritoriesInContinentExclusive(const Map &map, ContinentId continent, const std::vector<TerritoryId> &territories)
 {
+    return Map::areAllTerritoriesInContinent(map, continent, territories) && territories.size() == Map::getTerritoryIdsInContinent(map, continent).size();
+}
+
+bool Map::areAllTerritoriesInContinent(const Map &map, std::string_view continent, const std::vector<std::string> &territories)
+{
+    const auto continentId = map.continentIds.at(continent);
+
     // check if all territories are in the same continent
     for (auto &&territoryName : territories)
     {
-        if (map.territories.at(territoryName)->getContinent()->getName() != continent)
+        if (map.continentOfTerritory[map.territoryIds.at(territoryName)] != continentId)
+            return false;
+    }
+
+    return true;
+}
+
+bool Map::areAllTerritoriesInContinent(const Map &map, ContinentId continent, const std::vector<TerritoryId> &territories)
+{
+    // check if all territories are in the same continent
+    for (auto &&territory : territories)
+    {
+        if (map.continentOfTerritory[territory] != continent)
             return false;
     }
 
@@ -350,95 +630,227 @@ bool Map::areAllTerritoriesInContinent(const Map &map, const std::string &contin
 }
 
 // This function is included for convenience, works identically to its overloaded version.
-SharedTerritoriesVector Map::getAdjacentTerritories(const Map &map, const Territory &territory)
+TerritoriesVector Map::getAdjacentTerritories(const Map &map, const Territory &territory)
 {
-    return Map::getAdjacentTerritories(map, territory.getName());
+    return Map::getAdjacentTerritories(map, territory.getId());
 }
 
-SharedTerritoriesVector Map::getAdjacentTerritories(const Map &map, const std::string &territory)
+TerritoriesVector Map::getAdjacentTerritories(const Map &map, std::string_view territory)
 {
-    SharedTerritoriesVector adjacentTerritories{};
+    return Map::getAdjacentTerritories(map, map.territoryIds.at(territory));
+}
 
-    for (auto &&territoryName : map.adjacency.at(territory))
-    {
-        adjacentTerritories.push_back(map.territories.at(territoryName));
-    }
+TerritoriesVector Map::getAdjacentTerritories(const Map &map, TerritoryId territory)
+{
+    const auto neighbours = Map::getNeighbours(map, territory);
 
-    return adjacentTerritories;
+    return TerritoriesVector(neighbours.begin(), neighbours.end());
 }
 
 bool Map::areAdjacent(const Map &map, const Territory &territory1, const Territory &territory2)
 {
-    return Map::areAdjacent(map, territory1.getName(), territory2.getName());
+    return Map::areAdjacent(map, territory1.getId(), territory2.getId());
 }
 
-bool Map::areAdjacent(const Map &map, const std::string &territory1, const std::string &territory2)
+bool Map::areAdjacent(const Map &map, std::string_view territory1, std::string_view territory2)
 {
-    return std::find(map.adjacency.at(territory1).begin(), map.adjacency.at(territory1).end(), territory2) != map.adjacency.at(territory1).end();
+    return Map::areAdjacent(map, map.territoryIds.at(territory1), map.territoryIds.at(territory2));
 }
 
-void Map::countTraversedTerritories(const Map &map, const std::string &territory, std::unordered_set<std::string> *visited)
+bool Map::areAdjacent(const Map &map, TerritoryId territory1, TerritoryId territory2)
 {
-    visited->insert(territory);
+    if (!map.adjacencyMatrix.empty())
+        return (map.adjacencyMatrix[territory1][territory2 / 64] >> (territory2 % 64)) & 1;
 
-    for (auto &&territoryName : map.adjacency.at(territory))
+    const auto neighbours = Map::getAdjacentTerritoryIds(map, territory1);
+
+    return std::find(neighbours.begin(), neighbours.end(), territory2) != neighbours.end();
+}
+
+bool Map::hasAdjacencyMatrix(const Map &map)
+{
+    return !map.adjacencyMatrix.empty();
+}
+
+const AdjacencyRow *Map::getAdjacencyRow(const Map &map, TerritoryId territory)
+{
+    return map.adjacencyMatrix.empty() ? nullptr : &map.adjacencyMatrix[territory];
+}
+
+size_t Map::countCommonNeighbours(const Map &map, TerritoryId territory1, TerritoryId territory2)
+{
+    size_t commonNeighbours = 0;
+
+    if (!map.adjacencyMatrix.empty())
+    {
+        const auto &row1 = map.adjacencyMatrix[territory1], &row2 = map.adjacencyMatrix[territory2];
+
+        for (size_t word = 0; word < row1.size(); word++)
+            commonNeighbours += std::bitset<64>(row1[word] & row2[word]).count();
+
+        return commonNeighbours;
+    }
+
+    for (auto &&neighbour : Map::getAdjacentTerritoryIds(map, territory1))
     {
-        if (visited->find(territoryName) == visited->end())
-            Map::countTraversedTerritories(map, territoryName, visited);
+        if (Map::areAdjacent(map, territory2, neighbour))
+            commonNeighbours++;
     }
+
+    return commonNeighbours;
 }
 
-void Map::countTraversedTerritoriesInContinent(const Map &map, const std::string &continent, const std::string &territory, std::unordered_set<std::string> *visited)
+TerritoryId Map::getTerritoryId(const Map &map, std::string_view territory)
 {
-    visited->insert(territory);
+    const auto iterator = map.territoryIds.find(territory);
 
-    for (auto &&territoryName : map.adjacency.at(territory))
+    return iterator == map.territoryIds.end() ? INVALID_TERRITORY_ID : iterator->second;
+}
+
+Territory *Map::getTerritory(const Map &map, TerritoryId territory)
+{
+    return &map.territoriesById.at(territory);
+}
+
+const Continent *Map::getContinent(const Map &map, ContinentId continent)
+{
+    return &map.continentsById.at(continent);
+}
+
+TerritoryIdRange Map::getAdjacentTerritoryIds(const Map &map, TerritoryId territory)
+{
+    const auto *targets = map.adjacencyTargets.data();
+
+    return TerritoryIdRange{targets + map.adjacencyOffsets[territory], targets + map.adjacencyOffsets[territory + 1]};
+}
+
+// This function is included for convenience, works identically to its overloaded version.
+TerritoryRange Map::getNeighbours(const Map &map, const Territory &territory)
+{
+    return Map::getNeighbours(map, territory.getId());
+}
+
+TerritoryRange Map::getNeighbours(const Map &map, TerritoryId territory)
+{
+    return TerritoryRange(Map::getAdjacentTerritoryIds(map, territory), map.territoriesById.data());
+}
+
+ContinentId Map::getContinentId(const Map &map, std::string_view continent)
+{
+    const auto continentIterator = map.continentIds.find(continent);
+
+    return continentIterator == map.continentIds.end() ? INVALID_CONTINENT_ID : continentIterator->second;
+}
+
+ContinentId Map::getContinentId(const Map &map, TerritoryId territory)
+{
+    return map.continentOfTerritory[territory];
+}
+
+TerritoryIdRange Map::getTerritoryIdsInContinent(const Map &map, ContinentId continent)
+{
+    const auto *members = map.continentMembers.data();
+
+    return TerritoryIdRange{members + map.continentMemberOffsets[continent], members + map.continentMemberOffsets[continent + 1]};
+}
+
+TerritoryRange Map::getTerritoriesInContinent(const Map &map, ContinentId continent)
+{
+    return TerritoryRange(Map::getTerritoryIdsInContinent(map, continent), map.territoriesById.data());
+}
+
+// depth-first traversal with an explicit stack, marking every reached territory in the `visited` bit-vector
+// when `continentOf` is given, the traversal never leaves the continent of the starting territory
+static size_t countTraversedTerritories(const Map &map, TerritoryId start, const std::vector<ContinentId> *continentOf, std::vector<uint64_t> &visited, std::vector<TerritoryId> &stack)
+{
+    const auto markVisited = [&visited](TerritoryId territory)
     {
-        // if we haven't visited this territory before and is part of the continent we're looking at, continue the traversal
-        if (visited->find(territoryName) == visited->end() && map.territories.at(territoryName)->getContinent()->getName() == continent)
-            Map::countTraversedTerritoriesInContinent(map, continent, territoryName, visited);
+        const auto bit = uint64_t(1) << (territory % 64);
+
+        if (visited[territory / 64] & bit)
+            return false;
+
+        visited[territory / 64] |= bit;
+        return true;
+    };
+
+    size_t traversed = 0;
+    stack.clear();
+
+    if (markVisited(start))
+        stack.push_back(start);
+
+    while (!stack.empty())
+    {
+        const auto territory = stack.back();
+        stack.pop_back();
+        traversed++;
+
+        for (auto &&neighbour : Map::getAdjacentTerritoryIds(map, territory))
+        {
+            if ((continentOf == nullptr || (*continentOf)[neighbour] == (*continentOf)[start]) && markVisited(neighbour))
+                stack.push_back(neighbour);
+        }
     }
+
+    return traversed;
 }
 
 void Map::validate(Map *map)
 {
-    std::unordered_set<std::string> visitedTerritories;
-
-    if (*(map->validity) == MapValidity::NOTFOUND)
+    // maps the loader already rejected (e.g. unresolved neighbours) can't become valid
+    if (*(map->validity) == MapValidity::NOTFOUND || *(map->validity) == MapValidity::INVALID)
         return;
 
     *(map->validity) = MapValidity::UNKNOWN;
 
-    // 1: Map should be a connected graph
+    const auto territoryCount = map->territoriesById.size();
+    const auto continentCount = map->continentsById.size();
 
-    Map::countTraversedTerritories(*map, map->territories.begin()->first, &visitedTerritories);
-    if (visitedTerritories.size() != map->territories.size())
+    if (territoryCount == 0)
     {
         *(map->validity) = MapValidity::INVALID;
         return;
     }
 
-    for (auto &&pair : map->continents)
-    {
-        visitedTerritories.clear();
-
-        // 3: Each country belongs to one and only one continent
+    // 3: Each country belongs to one and only one continent
 
-        const auto territoriesInContinent = Map::getAllTerritoriesInContinent(*map, pair.first);
+    // if the # of known territories in a continent is not the same as the # of indexed territories (or the continent is empty), the map is invalid
+    for (ContinentId continent = 0; continent < continentCount; continent++)
+    {
+        const auto territoriesInContinent = Map::getTerritoryIdsInContinent(*map, continent).size();
 
-        // if the # of known territories in a continent is not the same as the # of loaded territories, the map is invalid
-        if (territoriesInContinent.size() != pair.second->getTerritoryCount())
+        if (territoriesInContinent == 0 || territoriesInContinent != map->continentsById[continent].getTerritoryCount())
         {
             *(map->validity) = MapValidity::INVALID;
             return;
         }
+    }
+
+    const auto wordCount = (territoryCount + 63) / 64;
+    std::vector<uint64_t> visited(wordCount, 0);
+    std::vector<TerritoryId> stack;
+    stack.reserve(territoryCount);
 
-        // 2: Continents are connected subgraphs
+    // 1: Map should be a connected graph
 
-        Map::countTraversedTerritoriesInContinent(*map, pair.first, territoriesInContinent.front()->getName(), &visitedTerritories);
+    if (countTraversedTerritories(*map, 0, nullptr, visited, stack) != territoryCount)
+    {
+        *(map->validity) = MapValidity::INVALID;
+        return;
+    }
 
+    // 2: Continents are connected subgraphs
+    // continents partition the territories, so every territory is visited once across all continents' traversals
+
+    visited.assign(wordCount, 0);
+
+    for (ContinentId continent = 0; continent < continentCount; continent++)
+    {
         // if the # of territories we traversed is not the same as the # of known territories in a continent, the map is invalid
-        if (visitedTerritories.size() != territoriesInContinent.size())
+        const auto members = Map::getTerritoryIdsInContinent(*map, continent);
+
+        if (countTraversedTerritories(*map, *members.begin(), &map->continentOfTerritory, visited, stack) != members.size())
         {
             *(map->validity) = MapValidity::INVALID;
             return;
@@ -448,111 +860,223 @@ void Map::validate(Map *map)
     *(map->validity) = MapValidity::VALID;
 }
 
-std::string Map::getImage() const { return *image; }
-std::string Map::getAuthor() const { return *author; }
-bool Map::getWrap() const { return *wrap; }
-ScrollDirection Map::getScroll() const { return *scroll; }
-MapValidity Map::getValidity() const { return *validity; }
-bool Map::getWarn() const { return warn; }
+std::string_view Map::NameArena::intern(std::string_view name)
+{
+    // blocks double in size, so a map's names take a handful of allocations whatever their number
+    if (used + name.size() > capacity)
+    {
+        capacity = std::max(name.size(), std::max<size_t>(capacity * 2, 256));
+        blocks.emplace_back(new char[capacity]);
+        used = 0;
+    }
 
-/* CONTINENT */
+    char *interned = blocks.back().get() + used;
+    std::copy(name.begin(), name.end(), interned);
+    used += name.size();
 
-Continent::Continent()
+    return std::string_view(interned, name.size());
+}
+
+ContinentId Map::addContinent(std::string_view name, uint16_t bonus)
 {
-    name = new std::string("");
-    bonus = new uint16_t(0);
-    territoryCount = new size_t(0);
+    if (continentIds.find(name) != continentIds.end())
+        return INVALID_CONTINENT_ID;
+
+    Continent continent;
+    continent.id = static_cast<ContinentId>(continentsById.size());
+    continent.name = names->intern(name);
+    continent.bonus = bonus;
+
+    const auto *previousContinents = continentsById.data();
+
+    continentIds.emplace(continent.name, continent.id);
+    continentsById.push_back(continent);
+
+    // if the array moved, the territories added so far are re-pointed at their continents
+    if (continentsById.data() != previousContinents)
+        bindContinents();
+
+    return continent.id;
 }
 
-Continent::Continent(const Continent &continent)
+TerritoryId Map::addTerritory(std::string_view name, uint16_t x, uint16_t y, ContinentId continent)
 {
-    name = continent.name;
-    bonus = continent.bonus;
-    territoryCount = continent.territoryCount;
+    if (continent >= continentsById.size() || territoryIds.find(name) != territoryIds.end())
+        return INVALID_TERRITORY_ID;
+
+    Territory territory;
+    territory.id = static_cast<TerritoryId>(territoriesById.size());
+    territory.x = x;
+    territory.y = y;
+
+    // a territory named like a continent shares the continent's interned name
+    const auto continentWithName = continentIds.find(name);
+    territory.name = continentWithName != continentIds.end() ? continentsById[continentWithName->second].name : names->intern(name);
+
+    // associate the territory with its continent
+    territory.continent = &continentsById[continent];
+    continentsById[continent].territoryCount++;
+
+    territoryIds.emplace(territory.name, territory.id);
+    territoriesById.push_back(territory);
+    continentOfTerritory.push_back(continent);
+
+    return territory.id;
 }
 
-Continent::~Continent()
+void Map::bindContinents()
 {
-    delete name, bonus, territoryCount;
+    for (auto &&territory : territoriesById)
+    {
+        territory.continent = &continentsById[continentOfTerritory[territory.id]];
+    }
 }
 
-Continent &Continent::operator=(const Continent &continent)
+void Map::buildIndexes()
 {
-    this->name = continent.name;
-    this->bonus = continent.bonus;
-    this->territoryCount = continent.territoryCount;
+    // continent members: counting sort of the territory IDs by continent, which keeps each continent's members in ID order
+    continentMemberOffsets.assign(continentsById.size() + 1, 0);
+    continentMembers.resize(continentOfTerritory.size());
 
-    return *this;
+    for (auto &&continent : continentOfTerritory)
+        continentMemberOffsets[continent + 1]++;
+
+    for (size_t continent = 0; continent < continentsById.size(); continent++)
+        continentMemberOffsets[continent + 1] += continentMemberOffsets[continent];
+
+    std::vector<uint32_t> nextMember(continentMemberOffsets.begin(), continentMemberOffsets.end() - 1);
+
+    for (TerritoryId territory = 0; territory < continentOfTerritory.size(); territory++)
+        continentMembers[nextMember[continentOfTerritory[territory]]++] = territory;
+
+    buildTopology();
+    buildSpatialIndex();
+
+    // distances computed over a previous adjacency are stale
+    distances = std::make_unique<DistanceCache>();
+
+    buildAdjacencyMatrix();
+}
+
+void Map::buildAdjacencyMatrix()
+{
+    // adjacency bit-matrix, only for maps small enough for it to stay in L1 (larger maps use the CSR arrays alone)
+    adjacencyMatrix.clear();
+
+    if (territoriesById.size() > MAX_TERRITORIES)
+        return;
+
+    adjacencyMatrix.assign(territoriesById.size(), AdjacencyRow{});
+
+    for (TerritoryId territory = 0; territory < territoriesById.size(); territory++)
+    {
+        for (auto &&neighbour : Map::getAdjacentTerritoryIds(*this, territory))
+            adjacencyMatrix[territory][neighbour / 64] |= uint64_t(1) << (neighbour % 64);
+    }
+}
+
+size_t Map::getTerritoryCount() const { return territoriesById.size(); }
+size_t Map::getContinentCount() const { return continentsById.size(); }
+std::string Map::getImage() const { return *image; }
+std::string Map::getAuthor() const { return *author; }
+bool Map::getWrap() const { return *wrap; }
+ScrollDirection Map::getScroll() const { return *scroll; }
+MapValidity Map::getValidity() const { return *validity; }
+bool Map::getWarn() const { return *warn; }
+
+/* CONTINENT */
+
+Continent::Continent()
+{
+    id = INVALID_CONTINENT_ID;
+    bonus = 0;
+    territoryCount = 0;
 }
 
 // Continent object stream insertion operator
 std::ostream &operator<<(std::ostream &os, const Continent &continent)
 {
-    os << "Continent: { Name: " << *continent.name << ", Bonus: " << *continent.bonus << " }";
+    os << "Continent: { Name: " << continent.name << ", Bonus: " << continent.bonus << " }";
 
     return os;
 }
 
-std::string Continent::getName() const { return *name; }
-uint16_t Continent::getBonus() const { return *bonus; }
-size_t Continent::getTerritoryCount() const { return *territoryCount; }
+ContinentId Continent::getId() const { return id; }
+std::string_view Continent::getName() const { return name; }
+uint16_t Continent::getBonus() const { return bonus; }
+size_t Continent::getTerritoryCount() const { return territoryCount; }
 
 /* TERRITORY */
 
 Territory::Territory()
 {
-    name = new std::string("");
-    x = new uint16_t(0);
-    y = new uint16_t(0);
-    owner = nullptr;
-
-    continent = std::make_shared<Continent>();
+    id = INVALID_TERRITORY_ID;
+    x = 0;
+    y = 0;
+    continent = nullptr;
 }
 
-Territory::Territory(const Territory &territory) : continent(territory.continent)
+// Territory object stream insertion operator
+std::ostream &operator<<(std::ostream &os, const Territory &territory)
 {
-    name = territory.name;
-    x = territory.x;
-    y = territory.y;
-    owner = nullptr;
-}
+    os << "Territory: { Name: " << territory.name << ", X: " << territory.x << ", Y: " << territory.y << ", Continent: " << territory.continent->getName() << " }";
 
-Territory::~Territory()
-{
-    delete name, x, y;
+    return os;
 }
 
-Territory &Territory::operator=(const Territory &territory)
+TerritoryId Territory::getId() const { return id; }
+std::string_view Territory::getName() const { return name; }
+uint16_t Territory::getX() const { return x; }
+uint16_t Territory::getY() const { return y; }
+const Continent *Territory::getContinent() const { return continent; }
+
+bool MapWriter::writeMap(const Map &map, const std::string &path)
 {
-    this->name = territory.name;
-    this->x = territory.x;
-    this->y = territory.y;
-    this->continent = territory.continent;
+    std::ofstream mapFile(path, std::ios::binary | std::ios::trunc);
 
-    return *this;
+    if (!mapFile.is_open())
+    {
+        std::cout << "Could not open file: " << path << std::endl;
+        return false;
+    }
+
+    writeMap(map, mapFile);
+
+    return mapFile.good();
 }
 
-// Territory object stream insertion operator
-std::ostream &operator<<(std::ostream &os, const Territory &territory)
+void MapWriter::writeMap(const Map &map, std::ostream &os)
 {
-    int unitQty = 2;
-    if (territory.getOwner() != nullptr)
+    const char *scroll = "none";
+    if (map.getScroll() == ScrollDirection::HORIZONTAL)
+        scroll = "horizontal";
+    else if (map.getScroll() == ScrollDirection::VERTICAL)
+        scroll = "vertical";
+
+    os << "[Map]\n";
+    os << "author=" << map.getAuthor() << '\n';
+    os << "image=" << map.getImage() << '\n';
+    os << "wrap=" << (map.getWrap() ? "yes" : "no") << '\n';
+    os << "scroll=" << scroll << '\n';
+    os << "warn=" << (map.getWarn() ? "yes" : "no") << '\n';
+
+    os << "\n[Continents]\n";
+    for (auto &&continent : Map::getAllContinents(map))
     {
-        unitQty = territory.getOwner()->getTerritoryUnits(&territory);
+        os << continent->getName() << '=' << continent->getBonus() << '\n';
     }
 
-    os << "Territory: { Name: " << *territory.name << ", X: " << *territory.x << ", Y: " << *territory.y << ", Continent: " << territory.continent->getName() << ", Owner: " << (territory.owner != nullptr ? territory.owner->getName() : "none") << ", Units: " << unitQty << " }";
-
-    return os;
-}
+    // territories are written in ID order, so reloading the file hands out the same IDs
+    os << "\n[Territories]\n";
+    for (auto &&territory : Map::getAllTerritories(map))
+    {
+        os << territory->getName() << ',' << territory->getX() << ',' << territory->getY() << ',' << territory->getContinent()->getName();
 
-std::string Territory::getName() const { return *name; }
-uint16_t Territory::getX() const { return *x; }
-uint16_t Territory::getY() const { return *y; }
-const std::shared_ptr<Continent> &Territory::getContinent() const { return continent; }
-Player *Territory::getOwner() const { return owner; }
+        for (auto neighbour : Map::getAdjacentTerritoryIds(map, territory->getId()))
+        {
+            os << ',' << Map::getTerritory(map, neighbour)->getName();
+        }
 
-void Territory::setOwner(Player *owner)
-{
-    this->owner = owner;
+        os << '\n';
+    }
 }
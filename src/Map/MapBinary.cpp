@@ -0,0 +1,564 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Map.h"
+
+/*
+    Compiled map (.mapbin) layout, version 2.
+
+    Every field is a fixed-width integer in the host's byte order, and every reference is an offset from the start of the
+    file, so the image is position independent and can be used straight out of an mmap. The header is followed by its
+    sections, each 8-byte aligned and listed in the header's section table (offset and record count):
+
+        MapBinaryContinent continents[continentCount]
+        MapBinaryTerritory territories[territoryCount]
+        uint32_t adjacencyOffsets[territoryCount + 1]         (CSR, same meaning as Map::adjacencyOffsets)
+        TerritoryId adjacencyTargets[]
+        uint32_t continentMemberOffsets[continentCount + 1]   (the continent membership index, as in Map)
+        TerritoryId continentMembers[territoryCount]
+        uint8_t topologyFlags[territoryCount]                 (the topology, as in Map)
+        TerritoryId articulationPoints[]
+        MapBinaryBridge bridges[]
+        uint32_t borderOffsets[continentCount + 1]
+        TerritoryId borderTerritories[]
+        uint32_t entryPointOffsets[continentCount + 1]
+        TerritoryId entryPoints[]
+        uint32_t cellOffsets[gridColumns * gridRows + 1]      (the spatial grid, as in Map::SpatialIndex)
+        TerritoryId cellTerritories[territoryCount]
+        char strings[]                                        (author, image and every name, not null-terminated)
+
+    Only maps that passed Map::validate are compiled, with every index buildIndexes derives from them, so a compiled map
+    is loaded as valid by copying its sections, without being traversed or indexed again (only the adjacency bit-matrix
+    of small maps is rebuilt, from the CSR arrays).
+*/
+
+namespace
+{
+    constexpr char MAP_BINARY_MAGIC[8] = {'R', 'I', 'S', 'K', 'M', 'A', 'P', 'B'};
+    constexpr uint32_t MAP_BINARY_VERSION = 2;
+
+    struct MapBinaryString
+    {
+        uint32_t offset; // relative to the start of the string table
+        uint32_t length;
+    };
+
+    struct MapBinarySection
+    {
+        uint64_t offset; // relative to the start of the file
+        uint64_t count;  // in records
+    };
+
+    // the header's section table, in file order
+    enum MapBinarySectionId : size_t
+    {
+        CONTINENTS,
+        TERRITORIES,
+        ADJACENCY_OFFSETS,
+        ADJACENCY_TARGETS,
+        CONTINENT_MEMBER_OFFSETS,
+        CONTINENT_MEMBERS,
+        TOPOLOGY_FLAGS,
+        ARTICULATION_POINTS,
+        BRIDGES,
+        BORDER_OFFSETS,
+        BORDER_TERRITORIES,
+        ENTRY_POINT_OFFSETS,
+        ENTRY_POINTS,
+        CELL_OFFSETS,
+        CELL_TERRITORIES,
+        STRINGS,
+        SECTION_COUNT
+    };
+
+    struct MapBinaryHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t sourceHash; // hash of the .map file this was compiled from
+        uint64_t fileSize;
+
+        uint32_t continentCount;
+        uint32_t territoryCount;
+        uint8_t wrap;
+        uint8_t scroll;
+        uint8_t warn;
+        uint8_t reserved;
+
+        MapBinaryString author;
+        MapBinaryString image;
+
+        // the spatial grid's geometry (its cells are the CELL_* sections)
+        int32_t gridOriginX;
+        int32_t gridOriginY;
+        int32_t gridWidth;
+        int32_t gridHeight;
+        uint32_t gridColumns;
+        uint32_t gridRows;
+        uint8_t gridWrapX;
+        uint8_t gridWrapY;
+        uint8_t gridReserved[2];
+
+        MapBinarySection sections[SECTION_COUNT];
+    };
+
+    struct MapBinaryContinent
+    {
+        MapBinaryString name;
+        uint32_t territoryCount;
+        uint16_t bonus;
+        uint16_t reserved;
+    };
+
+    struct MapBinaryTerritory
+    {
+        MapBinaryString name;
+        ContinentId continent;
+        uint16_t x;
+        uint16_t y;
+    };
+
+    struct MapBinaryBridge
+    {
+        TerritoryId first;
+        TerritoryId second;
+    };
+
+    static_assert(std::is_trivially_copyable<MapBinaryHeader>::value && sizeof(MapBinaryHeader) % 8 == 0 &&
+                      offsetof(MapBinaryHeader, sections) % 8 == 0,
+                  "header must be a flat, aligned record");
+    static_assert(std::is_trivially_copyable<MapBinaryContinent>::value && sizeof(MapBinaryContinent) == 16, "continent records must be flat");
+    static_assert(std::is_trivially_copyable<MapBinaryTerritory>::value && sizeof(MapBinaryTerritory) == 16, "territory records must be flat");
+    static_assert(std::is_trivially_copyable<MapBinaryBridge>::value && sizeof(MapBinaryBridge) == 8, "bridge records must be flat");
+
+    // read-only mapping of a whole file, unmapped when it goes out of scope
+    class MappedFile
+    {
+    private:
+        void *data = MAP_FAILED;
+        size_t size = 0;
+
+    public:
+        explicit MappedFile(const std::string &path)
+        {
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd == -1)
+                return;
+
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                size = static_cast<size_t>(info.st_size);
+                data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+
+            close(fd); // the mapping stays valid after the descriptor is closed
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile()
+        {
+            if (data != MAP_FAILED)
+                munmap(data, size);
+        }
+
+        bool isOpen() const { return data != MAP_FAILED; }
+        const char *begin() const { return static_cast<const char *>(data); }
+        size_t getSize() const { return size; }
+    };
+
+    uint64_t alignTo8(uint64_t offset)
+    {
+        return (offset + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    // true if [offset, offset + count * size) lies within the file and is suitably aligned for the record type
+    bool isSectionInFile(uint64_t offset, uint64_t count, uint64_t size, uint64_t alignment, uint64_t fileSize)
+    {
+        return offset % alignment == 0 && offset <= fileSize && count <= (fileSize - offset) / size;
+    }
+
+    // the records of a section, or nullptr unless it lies within the file, suitably aligned, and has `count` records
+    template <typename T>
+    const T *getSection(const char *base, uint64_t fileSize, const MapBinarySection &section, uint64_t count)
+    {
+        if (section.count != count || !isSectionInFile(section.offset, section.count, sizeof(T), alignof(T), fileSize))
+            return nullptr;
+
+        return reinterpret_cast<const T *>(base + section.offset);
+    }
+
+    bool areTerritoryIds(const TerritoryId *values, uint64_t valueCount, uint64_t territoryCount)
+    {
+        if (values == nullptr)
+            return false;
+
+        for (uint64_t i = 0; i < valueCount; i++)
+        {
+            if (values[i] >= territoryCount)
+                return false;
+        }
+
+        return true;
+    }
+
+    // true if `offsets` (groupCount + 1 of them) split the `values` section into consecutive runs of territory IDs
+    bool isRunIndex(const uint32_t *offsets, uint64_t groupCount, const TerritoryId *values, uint64_t valueCount, uint64_t territoryCount)
+    {
+        if (offsets == nullptr || offsets[0] != 0 || offsets[groupCount] != valueCount)
+            return false;
+
+        for (uint64_t group = 0; group < groupCount; group++)
+        {
+            if (offsets[group] > offsets[group + 1])
+                return false;
+        }
+
+        return areTerritoryIds(values, valueCount, territoryCount);
+    }
+
+    std::string_view getString(std::string_view strings, const MapBinaryString &string, bool &inBounds)
+    {
+        if (static_cast<uint64_t>(string.offset) + string.length > strings.size())
+        {
+            inBounds = false;
+            return "";
+        }
+
+        return strings.substr(string.offset, string.length);
+    }
+} // namespace
+
+uint64_t MapLoader::hashBytes(const char *bytes, size_t size, uint64_t hash)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+uint64_t MapLoader::hashMapFile(const std::string &path)
+{
+    const MappedFile file(path);
+
+    return file.isOpen() ? hashBytes(file.begin(), file.getSize()) : 0;
+}
+
+bool MapLoader::loadMapHeader(const std::string &path, MapHeader &header, uint64_t *hash)
+{
+    const MappedFile file(path);
+
+    header = MapHeader();
+    if (hash != nullptr)
+        *hash = 0;
+
+    // an empty file can't be mapped, but it's still a (headerless) map file, hashed 0 like hashMapFile does
+    if (!file.isOpen())
+    {
+        std::error_code error;
+        return std::filesystem::file_size(path, error) == 0 && !error;
+    }
+
+    parseMapHeader(std::string_view(file.begin(), file.getSize()), header, hash);
+    return true;
+}
+
+std::string MapLoader::getCompiledMapPath(const std::string &path)
+{
+    const std::string extension = ".map";
+
+    if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+        return path + "bin";
+
+    return path + ".mapbin";
+}
+
+std::shared_ptr<Map> MapLoader::loadMapCached(const std::string &path)
+{
+    const auto sourceHash = MapLoader::hashMapFile(path);
+    const auto compiledPath = MapLoader::getCompiledMapPath(path);
+
+    // a compiled map is only trusted if it was built from exactly this version of the source file
+    if (sourceHash != 0)
+    {
+        const auto compiledMap = MapLoader::loadCompiledMap(compiledPath, sourceHash);
+
+        if (compiledMap != nullptr)
+            return compiledMap;
+    }
+
+    // tagged with the hash of the bytes actually parsed, so an edit made since the hash above can't leave a stale cache
+    uint64_t parsedHash = 0;
+    const auto map = MapLoader::loadMap(path, &parsedHash);
+    Map::validate(map.get());
+
+    if (map->getValidity() == MapValidity::VALID && parsedHash != 0)
+        MapLoader::writeCompiledMap(*map, compiledPath, parsedHash);
+
+    return map;
+}
+
+std::shared_ptr<Map> MapLoader::loadCompiledMap(const std::string &path, uint64_t sourceHash)
+{
+    const MappedFile file(path);
+
+    if (!file.isOpen() || file.getSize() < sizeof(MapBinaryHeader))
+        return nullptr;
+
+    const auto *base = file.begin();
+    const auto &header = *reinterpret_cast<const MapBinaryHeader *>(base);
+    const uint64_t fileSize = file.getSize();
+
+    // stale, foreign or truncated files are rejected so the caller rebuilds them
+    if (std::memcmp(header.magic, MAP_BINARY_MAGIC, sizeof(MAP_BINARY_MAGIC)) != 0 || header.version != MAP_BINARY_VERSION ||
+        header.headerSize != sizeof(MapBinaryHeader) || header.sourceHash != sourceHash || header.fileSize != fileSize ||
+        header.scroll > static_cast<uint8_t>(ScrollDirection::VERTICAL) || header.gridColumns == 0 || header.gridRows == 0 ||
+        header.gridWidth <= 0 || header.gridHeight <= 0)
+        return nullptr;
+
+    const uint64_t continentCount = header.continentCount, territoryCount = header.territoryCount;
+    const uint64_t cellCount = static_cast<uint64_t>(header.gridColumns) * header.gridRows;
+    const auto &sections = header.sections;
+
+    // every section is bounds-checked, and every ID in it checked against the map, before anything is read from it
+    const auto *continents = getSection<MapBinaryContinent>(base, fileSize, sections[CONTINENTS], continentCount);
+    const auto *territories = getSection<MapBinaryTerritory>(base, fileSize, sections[TERRITORIES], territoryCount);
+    const auto *adjacencyOffsets = getSection<uint32_t>(base, fileSize, sections[ADJACENCY_OFFSETS], territoryCount + 1);
+    const auto *adjacencyTargets = getSection<TerritoryId>(base, fileSize, sections[ADJACENCY_TARGETS], sections[ADJACENCY_TARGETS].count);
+    const auto *memberOffsets = getSection<uint32_t>(base, fileSize, sections[CONTINENT_MEMBER_OFFSETS], continentCount + 1);
+    const auto *members = getSection<TerritoryId>(base, fileSize, sections[CONTINENT_MEMBERS], territoryCount);
+    const auto *topologyFlags = getSection<uint8_t>(base, fileSize, sections[TOPOLOGY_FLAGS], territoryCount);
+    const auto *articulationPoints = getSection<TerritoryId>(base, fileSize, sections[ARTICULATION_POINTS], sections[ARTICULATION_POINTS].count);
+    const auto *bridges = getSection<MapBinaryBridge>(base, fileSize, sections[BRIDGES], sections[BRIDGES].count);
+    const auto *borderOffsets = getSection<uint32_t>(base, fileSize, sections[BORDER_OFFSETS], continentCount + 1);
+    const auto *borderTerritories = getSection<TerritoryId>(base, fileSize, sections[BORDER_TERRITORIES], sections[BORDER_TERRITORIES].count);
+    const auto *entryPointOffsets = getSection<uint32_t>(base, fileSize, sections[ENTRY_POINT_OFFSETS], continentCount + 1);
+    const auto *entryPoints = getSection<TerritoryId>(base, fileSize, sections[ENTRY_POINTS], sections[ENTRY_POINTS].count);
+    const auto *cellOffsets = getSection<uint32_t>(base, fileSize, sections[CELL_OFFSETS], cellCount + 1);
+    const auto *cellTerritories = getSection<TerritoryId>(base, fileSize, sections[CELL_TERRITORIES], territoryCount);
+    const auto *strings = getSection<char>(base, fileSize, sections[STRINGS], sections[STRINGS].count);
+
+    if (continents == nullptr || territories == nullptr || topologyFlags == nullptr || bridges == nullptr || strings == nullptr ||
+        !areTerritoryIds(articulationPoints, sections[ARTICULATION_POINTS].count, territoryCount) ||
+        !isRunIndex(adjacencyOffsets, territoryCount, adjacencyTargets, sections[ADJACENCY_TARGETS].count, territoryCount) ||
+        !isRunIndex(memberOffsets, continentCount, members, territoryCount, territoryCount) ||
+        !isRunIndex(borderOffsets, continentCount, borderTerritories, sections[BORDER_TERRITORIES].count, territoryCount) ||
+        !isRunIndex(entryPointOffsets, continentCount, entryPoints, sections[ENTRY_POINTS].count, territoryCount) ||
+        !isRunIndex(cellOffsets, cellCount, cellTerritories, territoryCount, territoryCount))
+        return nullptr;
+
+    for (uint64_t i = 0; i < sections[BRIDGES].count; i++)
+    {
+        if (bridges[i].first >= territoryCount || bridges[i].second >= territoryCount)
+            return nullptr;
+    }
+
+    std::shared_ptr<Map> map = std::make_shared<Map>();
+    bool inBounds = true;
+
+    // the string table is copied into the map's names in one go, and every name is a view into it
+    const auto names = map->names->intern(std::string_view(strings, sections[STRINGS].count));
+
+    *map->author = getString(names, header.author, inBounds);
+    *map->image = getString(names, header.image, inBounds);
+    *map->wrap = header.wrap != 0;
+    *map->scroll = static_cast<ScrollDirection>(header.scroll);
+    *map->warn = header.warn != 0;
+
+    map->continentIds.reserve(continentCount);
+    map->continentsById.resize(continentCount);
+
+    for (ContinentId id = 0; id < continentCount && inBounds; id++)
+    {
+        auto &continent = map->continentsById[id];
+        continent.id = id;
+        continent.name = getString(names, continents[id].name, inBounds);
+        continent.bonus = continents[id].bonus;
+        continent.territoryCount = memberOffsets[id + 1] - memberOffsets[id];
+
+        inBounds = inBounds && map->continentIds.emplace(continent.name, id).second;
+    }
+
+    map->territoryIds.reserve(territoryCount);
+    map->territoriesById.resize(territoryCount);
+    map->continentOfTerritory.resize(territoryCount);
+
+    for (TerritoryId id = 0; id < territoryCount && inBounds; id++)
+    {
+        auto &territory = map->territoriesById[id];
+        const auto continent = territories[id].continent;
+        inBounds = continent < continentCount;
+
+        territory.id = id;
+        territory.x = territories[id].x;
+        territory.y = territories[id].y;
+        territory.name = getString(names, territories[id].name, inBounds);
+        territory.continent = inBounds ? &map->continentsById[continent] : nullptr;
+        map->continentOfTerritory[id] = continent;
+
+        inBounds = inBounds && map->territoryIds.emplace(territory.name, id).second;
+    }
+
+    // the membership index has to agree with the territories' own continents
+    for (ContinentId continent = 0; continent < continentCount && inBounds; continent++)
+    {
+        for (uint32_t i = memberOffsets[continent]; i < memberOffsets[continent + 1] && inBounds; i++)
+            inBounds = territories[members[i]].continent == continent;
+    }
+
+    if (!inBounds)
+        return nullptr;
+
+    map->adjacencyOffsets.assign(adjacencyOffsets, adjacencyOffsets + territoryCount + 1);
+    map->adjacencyTargets.assign(adjacencyTargets, adjacencyTargets + sections[ADJACENCY_TARGETS].count);
+    map->continentMemberOffsets.assign(memberOffsets, memberOffsets + continentCount + 1);
+    map->continentMembers.assign(members, members + territoryCount);
+
+    map->topologyFlags.assign(topologyFlags, topologyFlags + territoryCount);
+    map->articulationPoints.assign(articulationPoints, articulationPoints + sections[ARTICULATION_POINTS].count);
+    map->bridges.reserve(sections[BRIDGES].count);
+    for (uint64_t i = 0; i < sections[BRIDGES].count; i++)
+        map->bridges.emplace_back(bridges[i].first, bridges[i].second);
+    map->borderOffsets.assign(borderOffsets, borderOffsets + continentCount + 1);
+    map->borderTerritories.assign(borderTerritories, borderTerritories + sections[BORDER_TERRITORIES].count);
+    map->entryPointOffsets.assign(entryPointOffsets, entryPointOffsets + continentCount + 1);
+    map->entryPoints.assign(entryPoints, entryPoints + sections[ENTRY_POINTS].count);
+
+    auto &grid = map->spatialIndex;
+    grid.originX = header.gridOriginX;
+    grid.originY = header.gridOriginY;
+    grid.width = header.gridWidth;
+    grid.height = header.gridHeight;
+    grid.wrapX = header.gridWrapX != 0;
+    grid.wrapY = header.gridWrapY != 0;
+    grid.columns = header.gridColumns;
+    grid.rows = header.gridRows;
+    grid.cellOffsets.assign(cellOffsets, cellOffsets + cellCount + 1);
+    grid.cellTerritories.assign(cellTerritories, cellTerritories + territoryCount);
+
+    map->buildAdjacencyMatrix();
+    *map->validity = MapValidity::VALID;
+
+    return map;
+}
+
+bool MapLoader::writeCompiledMap(const Map &map, const std::string &path, uint64_t sourceHash)
+{
+    if (map.getValidity() != MapValidity::VALID)
+        return false;
+
+    std::string strings;
+    const auto addString = [&strings](std::string_view string)
+    {
+        const MapBinaryString reference{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(string.size())};
+        strings += string;
+        return reference;
+    };
+
+    MapBinaryHeader header{};
+    std::memcpy(header.magic, MAP_BINARY_MAGIC, sizeof(MAP_BINARY_MAGIC));
+    header.version = MAP_BINARY_VERSION;
+    header.headerSize = sizeof(MapBinaryHeader);
+    header.sourceHash = sourceHash;
+    header.continentCount = static_cast<uint32_t>(map.continentsById.size());
+    header.territoryCount = static_cast<uint32_t>(map.territoriesById.size());
+    header.wrap = *map.wrap;
+    header.scroll = static_cast<uint8_t>(*map.scroll);
+    header.warn = *map.warn;
+    header.author = addString(*map.author);
+    header.image = addString(*map.image);
+
+    const auto &grid = map.spatialIndex;
+    header.gridOriginX = grid.originX;
+    header.gridOriginY = grid.originY;
+    header.gridWidth = grid.width;
+    header.gridHeight = grid.height;
+    header.gridColumns = grid.columns;
+    header.gridRows = grid.rows;
+    header.gridWrapX = grid.wrapX;
+    header.gridWrapY = grid.wrapY;
+
+    std::vector<MapBinaryContinent> continents;
+    continents.reserve(map.continentsById.size());
+    for (auto &&continent : map.continentsById)
+    {
+        continents.push_back(MapBinaryContinent{addString(continent.name), static_cast<uint32_t>(continent.territoryCount), continent.bonus, 0});
+    }
+
+    std::vector<MapBinaryTerritory> territories;
+    territories.reserve(map.territoriesById.size());
+    for (auto &&territory : map.territoriesById)
+    {
+        territories.push_back(MapBinaryTerritory{addString(territory.name), territory.continent->id, territory.x, territory.y});
+    }
+
+    std::vector<MapBinaryBridge> bridges;
+    bridges.reserve(map.bridges.size());
+    for (auto &&bridge : map.bridges)
+    {
+        bridges.push_back(MapBinaryBridge{bridge.first, bridge.second});
+    }
+
+    // the image is assembled in memory, each section appended at the next 8-byte boundary, then the header written in front
+    std::string image(sizeof(MapBinaryHeader), '\0');
+    const auto addSection = [&image, &header](MapBinarySectionId id, const auto &records)
+    {
+        image.resize(alignTo8(image.size()), '\0');
+        header.sections[id] = MapBinarySection{image.size(), records.size()};
+
+        if (!records.empty())
+            image.append(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(records[0]));
+    };
+
+    addSection(CONTINENTS, continents);
+    addSection(TERRITORIES, territories);
+    addSection(ADJACENCY_OFFSETS, map.adjacencyOffsets);
+    addSection(ADJACENCY_TARGETS, map.adjacencyTargets);
+    addSection(CONTINENT_MEMBER_OFFSETS, map.continentMemberOffsets);
+    addSection(CONTINENT_MEMBERS, map.continentMembers);
+    addSection(TOPOLOGY_FLAGS, map.topologyFlags);
+    addSection(ARTICULATION_POINTS, map.articulationPoints);
+    addSection(BRIDGES, bridges);
+    addSection(BORDER_OFFSETS, map.borderOffsets);
+    addSection(BORDER_TERRITORIES, map.borderTerritories);
+    addSection(ENTRY_POINT_OFFSETS, map.entryPointOffsets);
+    addSection(ENTRY_POINTS, map.entryPoints);
+    addSection(CELL_OFFSETS, grid.cellOffsets);
+    addSection(CELL_TERRITORIES, grid.cellTerritories);
+    addSection(STRINGS, strings);
+
+    header.fileSize = image.size();
+    std::memcpy(&image[0], &header, sizeof(header));
+
+    // written next to its final location and renamed over it, so readers never see half a file
+    const auto temporaryPath = path + ".tmp" + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+    // a failed write or rename leaves no temporary file behind
+    file.write(image.data(), image.size());
+    file.close();
+
+    if (file.fail() || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
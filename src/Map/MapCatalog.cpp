@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+#include <unistd.h>
+
+#include "MapCatalog.h"
+
+namespace
+{
+    constexpr const char *MAP_CATALOG_VERSION = "RISKMAPCATALOG 1";
+
+    // tabs and line breaks would break the index's lines, so they're stored as spaces
+    std::string sanitize(const std::string &value)
+    {
+        std::string sanitized = value;
+        std::replace_if(sanitized.begin(), sanitized.end(), [](char c)
+                        { return c == '\t' || c == '\n' || c == '\r'; },
+                        ' ');
+        return sanitized;
+    }
+
+    template <typename Integer>
+    bool parseField(std::string_view field, Integer &value)
+    {
+        return std::from_chars(field.data(), field.data() + field.size(), value).ec == std::errc();
+    }
+
+    // the fields of an index line, in the order writeIndex puts them
+    bool parseIndexLine(std::string_view line, const std::string &directory, MapCatalogEntry &entry)
+    {
+        std::string_view fields[11];
+        size_t fieldCount = 0;
+
+        for (size_t fieldBegin = 0; fieldCount < 11 && fieldBegin <= line.size(); fieldCount++)
+        {
+            auto fieldEnd = line.find('\t', fieldBegin);
+            if (fieldEnd == std::string_view::npos)
+                fieldEnd = line.size();
+
+            fields[fieldCount] = line.substr(fieldBegin, fieldEnd - fieldBegin);
+            fieldBegin = fieldEnd + 1;
+        }
+
+        int scroll = 0;
+
+        if (fieldCount != 11 || fields[0].empty() || !parseField(fields[1], entry.fileSize) || !parseField(fields[2], entry.modifiedTime) ||
+            !parseField(fields[3], entry.hash) || !parseField(fields[4], entry.header.continentCount) || !parseField(fields[5], entry.header.territoryCount) ||
+            !parseField(fields[6], scroll) || scroll < 0 || scroll > static_cast<int>(ScrollDirection::VERTICAL))
+            return false;
+
+        entry.path = (std::filesystem::path(directory) / fields[0]).string();
+        entry.header.scroll = static_cast<ScrollDirection>(scroll);
+        entry.header.wrap = fields[7] == "1";
+        entry.header.warn = fields[8] == "1";
+        entry.header.author = fields[9];
+        entry.header.image = fields[10];
+
+        return true;
+    }
+} // namespace
+
+std::string MapCatalog::getIndexPath(const std::string &directory)
+{
+    return (std::filesystem::path(directory) / ".mapcatalog").string();
+}
+
+bool MapCatalog::scanMapFile(const std::string &path, MapCatalogEntry &entry)
+{
+    std::error_code error;
+
+    entry.path = path;
+    entry.fileSize = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+
+    entry.modifiedTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    if (error)
+        return false;
+
+    // one pass over the mapped file for both its hash and its header
+    return MapLoader::loadMapHeader(path, entry.header, &entry.hash);
+}
+
+std::vector<MapCatalogEntry> MapCatalog::scanDirectory(const std::string &directory, size_t *rescannedFiles)
+{
+    std::vector<MapCatalogEntry> entries;
+    size_t rescanned = 0;
+    std::error_code error;
+
+    // previous results by path
+    std::unordered_map<std::string, MapCatalogEntry> indexed;
+    for (auto &&entry : MapCatalog::readIndex(directory))
+    {
+        auto path = entry.path;
+        indexed.emplace(std::move(path), std::move(entry));
+    }
+
+    for (std::filesystem::directory_iterator file(directory, error), end; !error && file != end; file.increment(error))
+    {
+        if (!file->is_regular_file() || file->path().extension() != ".map")
+            continue;
+
+        const auto path = file->path().string();
+        const auto size = file->file_size(error);
+        const auto modifiedTime = file->last_write_time(error).time_since_epoch().count();
+
+        if (error)
+        {
+            error.clear();
+            continue;
+        }
+
+        // unchanged since the last scan: the indexed entry is still accurate
+        const auto previous = indexed.find(path);
+        if (previous != indexed.end() && previous->second.fileSize == size && previous->second.modifiedTime == modifiedTime)
+        {
+            entries.push_back(std::move(previous->second));
+            continue;
+        }
+
+        MapCatalogEntry entry;
+        if (MapCatalog::scanMapFile(path, entry))
+        {
+            entries.push_back(std::move(entry));
+            rescanned++;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const MapCatalogEntry &entry1, const MapCatalogEntry &entry2)
+              { return entry1.path < entry2.path; });
+
+    // the index is rewritten only if something was added, changed or removed
+    if (rescanned > 0 || entries.size() != indexed.size())
+        MapCatalog::writeIndex(directory, entries);
+
+    if (rescannedFiles != nullptr)
+        *rescannedFiles = rescanned;
+
+    return entries;
+}
+
+std::vector<MapCatalogEntry> MapCatalog::readIndex(const std::string &directory)
+{
+    std::vector<MapCatalogEntry> entries;
+    std::ifstream index(MapCatalog::getIndexPath(directory));
+    std::string line;
+
+    // a missing index, or one of another version, is the same as an empty one
+    if (!std::getline(index, line) || line != MAP_CATALOG_VERSION)
+        return entries;
+
+    while (std::getline(index, line))
+    {
+        MapCatalogEntry entry;
+
+        if (parseIndexLine(line, directory, entry))
+            entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+bool MapCatalog::writeIndex(const std::string &directory, const std::vector<MapCatalogEntry> &entries)
+{
+    // written next to the index and renamed over it, so a concurrent scan reads either the old index or the new one;
+    // every writer has its own temporary file, removed if the write or the rename fails
+    const auto indexPath = MapCatalog::getIndexPath(directory);
+    const auto temporaryPath = indexPath + ".tmp" + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::error_code error;
+
+    {
+        std::ofstream index(temporaryPath, std::ios::trunc);
+        if (!index.is_open())
+            return false;
+
+        index << MAP_CATALOG_VERSION << '\n';
+
+        for (auto &&entry : entries)
+        {
+            index << sanitize(std::filesystem::path(entry.path).filename().string()) << '\t' << entry.fileSize << '\t' << entry.modifiedTime << '\t' << entry.hash << '\t'
+                  << entry.header.continentCount << '\t' << entry.header.territoryCount << '\t' << static_cast<int>(entry.header.scroll) << '\t'
+                  << (entry.header.wrap ? 1 : 0) << '\t' << (entry.header.warn ? 1 : 0) << '\t' << sanitize(entry.header.author) << '\t' << sanitize(entry.header.image) << '\n';
+        }
+
+        if (!index)
+        {
+            index.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, indexPath, error);
+    if (!error)
+        return true;
+
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+}
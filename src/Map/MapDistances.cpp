@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "Map.h"
+
+/*
+    Hop distances between territories.
+
+    Every query needs the BFS row of its source territory: distances[t] is the number of hops from the source to t,
+    and nextHops[t] the neighbour of the source that starts a shortest path to t (the BFS tree's first step).
+    Small maps compute all rows on the first query and keep them as two row-major matrices of uint16_t, after which
+    a query is a single load. Larger maps keep a few rows, evicting the least recently used one (and reusing its buffers).
+*/
+
+// breadth-first search from `source`, filling its row; `queue` is a reusable buffer
+template <typename Distance, typename Hop>
+static void fillDistanceRow(const Map &map, TerritoryId source, Distance *distances, Hop *nextHops, std::vector<TerritoryId> &queue)
+{
+    const auto territoryCount = map.getTerritoryCount();
+    constexpr auto unreachable = std::numeric_limits<Distance>::max();
+    constexpr auto noHop = std::numeric_limits<Hop>::max();
+
+    std::fill(distances, distances + territoryCount, unreachable);
+    std::fill(nextHops, nextHops + territoryCount, noHop);
+
+    queue.resize(territoryCount);
+    size_t head = 0, tail = 0;
+
+    distances[source] = 0;
+    queue[tail++] = source;
+
+    while (head < tail)
+    {
+        const auto territory = queue[head++];
+
+        for (auto &&neighbour : Map::getAdjacentTerritoryIds(map, territory))
+        {
+            if (distances[neighbour] != unreachable)
+                continue;
+
+            distances[neighbour] = static_cast<Distance>(distances[territory] + 1);
+            nextHops[neighbour] = territory == source ? static_cast<Hop>(neighbour) : nextHops[territory];
+            queue[tail++] = neighbour;
+        }
+    }
+}
+
+// the row of `source` among the cached ones, running its BFS into the least recently used row on a miss (the cache must be locked)
+Map::DistanceCache::Row &Map::getDistanceRow(const Map &map, TerritoryId source)
+{
+    auto &cache = *map.distances;
+
+    cache.clock++;
+
+    auto row = std::find_if(cache.rows.begin(), cache.rows.end(), [source](const Map::DistanceCache::Row &row)
+                            { return row.source == source; });
+
+    if (row == cache.rows.end())
+    {
+        if (cache.rows.size() < DISTANCE_CACHE_ROWS)
+        {
+            cache.rows.emplace_back();
+            row = cache.rows.end() - 1;
+        }
+        else
+        {
+            row = std::min_element(cache.rows.begin(), cache.rows.end(), [](const Map::DistanceCache::Row &row1, const Map::DistanceCache::Row &row2)
+                                   { return row1.lastUse < row2.lastUse; });
+        }
+
+        row->source = source;
+        row->distances.resize(map.getTerritoryCount());
+        row->nextHops.resize(map.getTerritoryCount());
+
+        fillDistanceRow(map, source, row->distances.data(), row->nextHops.data(), cache.queue);
+    }
+
+    row->lastUse = cache.clock;
+
+    return *row;
+}
+
+// computes the full matrices on the first call; later calls only check an atomic flag
+bool Map::ensureDistanceMatrix(const Map &map)
+{
+    auto &cache = *map.distances;
+    const auto territoryCount = map.getTerritoryCount();
+
+    if (territoryCount > MAX_DISTANCE_MATRIX_TERRITORIES)
+        return false;
+
+    if (cache.matrixBuilt.load(std::memory_order_acquire))
+        return true;
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    if (!cache.matrixBuilt.load(std::memory_order_relaxed))
+    {
+        cache.matrixDistances.resize(territoryCount * territoryCount);
+        cache.matrixNextHops.resize(territoryCount * territoryCount);
+
+        for (TerritoryId source = 0; source < territoryCount; source++)
+            fillDistanceRow(map, source, &cache.matrixDistances[source * territoryCount], &cache.matrixNextHops[source * territoryCount], cache.queue);
+
+        cache.matrixBuilt.store(true, std::memory_order_release);
+    }
+
+    return true;
+}
+
+uint32_t Map::distance(const Map &map, TerritoryId from, TerritoryId to)
+{
+    auto &cache = *map.distances;
+
+    if (ensureDistanceMatrix(map))
+    {
+        const auto distance = cache.matrixDistances[from * map.getTerritoryCount() + to];
+
+        return distance == std::numeric_limits<uint16_t>::max() ? UNREACHABLE_DISTANCE : distance;
+    }
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    return getDistanceRow(map, from).distances[to];
+}
+
+TerritoryId Map::nextHop(const Map &map, TerritoryId from, TerritoryId to)
+{
+    auto &cache = *map.distances;
+
+    if (ensureDistanceMatrix(map))
+    {
+        const auto hop = cache.matrixNextHops[from * map.getTerritoryCount() + to];
+
+        return hop == std::numeric_limits<uint16_t>::max() ? INVALID_TERRITORY_ID : hop;
+    }
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    return getDistanceRow(map, from).nextHops[to];
+}
@@ -1,6 +1,41 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
 
+#include "AllocationCounter.h"
 #include "Map.h"
+#include "MapCatalog.h"
+#include "MapGenerator.h"
+#include "MapWatcher.h"
+#include "ThreadPool.h"
+
+// writes a generated map (about a hundred territories per continent) to the temp directory and returns its path
+static std::string writeGeneratedMap(MapFamily family, size_t territoryCount)
+{
+    const auto map = MapGenerator::generate({family, territoryCount, std::max<size_t>(1, territoryCount / 100), 42});
+    const auto path = (std::filesystem::temp_directory_path() / ("generated_" + std::to_string(territoryCount) + ".map")).string();
+
+    MapWriter::writeMap(*map, path);
+
+    return path;
+}
+
+// average wall-clock time of `runs` calls to MapLoader::loadMap, in milliseconds
+static double timeMapLoad(const std::string &path, int runs)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < runs; i++)
+        MapLoader::loadMap(path);
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+}
 
 void testLoadMap(const std::string &mapLocation)
 {
@@ -38,6 +73,25 @@ void testLoadMap(const std::string &mapLocation)
         std::cout << *territory << std::endl;
     }
 
+    std::cout << "\nADJACENCY BY ID TEST" << std::endl;
+
+    const auto testTerritoryId = Map::getTerritoryId(*map, testTerritory->getName());
+    for (auto &&neighbour : Map::getAdjacentTerritoryIds(*map, testTerritoryId))
+    {
+        std::cout << neighbour << ": " << Map::getTerritory(*map, neighbour)->getName() << " (adjacent: " << std::boolalpha << Map::areAdjacent(*map, testTerritoryId, neighbour) << ")" << std::endl;
+    }
+
+    std::cout << "\nSHORTEST PATH TEST" << std::endl;
+
+    const auto lastTerritoryId = static_cast<TerritoryId>(map->getTerritoryCount() - 1);
+    std::cout << "Distance from " << testTerritory->getName() << " to " << territories.back()->getName() << ": " << Map::distance(*map, testTerritoryId, lastTerritoryId) << std::endl;
+
+    for (auto territory = testTerritoryId; territory != INVALID_TERRITORY_ID; territory = Map::nextHop(*map, territory, lastTerritoryId))
+    {
+        std::cout << Map::getTerritory(*map, territory)->getName() << (territory == lastTerritoryId ? "" : " -> ");
+    }
+    std::cout << std::endl;
+
     std::cout << "\nSAME CONTINENT TERRITORIES TEST" << std::endl;
 
     const auto sameContinentTerritories = Map::getAllTerritoriesInContinent(*map, *testTerritory->getContinent());
@@ -45,6 +99,58 @@ void testLoadMap(const std::string &mapLocation)
     {
         std::cout << *territory << std::endl;
     }
+
+    std::cout << "\nCHOKEPOINTS TEST" << std::endl;
+
+    std::cout << "Articulation points:";
+    for (auto &&territory : Map::getArticulationPoints(*map))
+    {
+        std::cout << " " << Map::getTerritory(*map, territory)->getName() << ";";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Bridges:";
+    for (auto &&bridge : Map::getBridges(*map))
+    {
+        std::cout << " " << Map::getTerritory(*map, bridge.first)->getName() << " - " << Map::getTerritory(*map, bridge.second)->getName() << ";";
+    }
+    std::cout << std::endl;
+
+    const auto testContinentId = Map::getContinentId(*map, testTerritoryId);
+
+    std::cout << "Border territories of " << testTerritory->getContinent()->getName() << ":";
+    for (auto &&territory : Map::getBorderTerritories(*map, testContinentId))
+    {
+        std::cout << " " << territory->getName() << ";";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Entry points of " << testTerritory->getContinent()->getName() << ":";
+    for (auto &&territory : Map::getEntryPoints(*map, testContinentId))
+    {
+        std::cout << " " << territory->getName() << ";";
+    }
+    std::cout << std::endl;
+
+    std::cout << "\nSPATIAL INDEX TEST" << std::endl;
+
+    std::vector<TerritoryId> spatialTerritories;
+
+    Map::getNearestTerritoryIds(*map, testTerritory->getX(), testTerritory->getY(), 4, spatialTerritories);
+    std::cout << "Nearest to " << testTerritory->getName() << ":";
+    for (auto &&territory : spatialTerritories)
+    {
+        std::cout << " " << Map::getTerritory(*map, territory)->getName() << ";";
+    }
+    std::cout << std::endl;
+
+    Map::getTerritoryIdsInRect(*map, testTerritory->getX() - 50, testTerritory->getY() - 50, testTerritory->getX() + 50, testTerritory->getY() + 50, spatialTerritories);
+    std::cout << "Within 50 of " << testTerritory->getName() << " (wrap: " << std::boolalpha << map->getWrap() << "):";
+    for (auto &&territory : spatialTerritories)
+    {
+        std::cout << " " << Map::getTerritory(*map, territory)->getName() << ";";
+    }
+    std::cout << std::endl;
 }
 
 void testLoadMaps()
@@ -57,4 +163,369 @@ void testLoadMaps()
 
         std::cout << std::endl;
     }
-}
\ No newline at end of file
+
+    std::cout << "GENERATED MAPS TEST" << std::endl;
+
+    const auto path = (std::filesystem::temp_directory_path() / "generated_test.map").string();
+
+    for (auto &&family : {MapFamily::GRID, MapFamily::CONTINENT_RING, MapFamily::RANDOM_GEOMETRIC, MapFamily::SCALE_FREE})
+    {
+        const auto generated = MapGenerator::generate({family, 200, 6, 42});
+
+        // written out and loaded back, a generated map must come back identical (same IDs, same neighbours)
+        MapWriter::writeMap(*generated, path);
+        const auto reloaded = MapLoader::loadMap(path);
+        Map::validate(reloaded.get());
+
+        bool identical = reloaded->getTerritoryCount() == generated->getTerritoryCount();
+        for (TerritoryId territory = 0; identical && territory < generated->getTerritoryCount(); territory++)
+        {
+            const auto generatedNeighbours = Map::getAdjacentTerritoryIds(*generated, territory);
+            const auto reloadedNeighbours = Map::getAdjacentTerritoryIds(*reloaded, territory);
+
+            identical = std::equal(generatedNeighbours.begin(), generatedNeighbours.end(), reloadedNeighbours.begin(), reloadedNeighbours.end());
+        }
+
+        std::cout << family << ": " << generated->getTerritoryCount() << " territories, " << generated->getContinentCount() << " continents, " << generated->getValidity()
+                  << ", reloaded: " << reloaded->getValidity() << ", identical: " << std::boolalpha << identical << std::endl;
+    }
+
+    std::filesystem::remove(path);
+
+    std::cout << "\nMAP CATALOG TEST" << std::endl;
+
+    size_t rescannedFiles = 0;
+    for (auto &&entry : MapCatalog::scanDirectory("maps", &rescannedFiles))
+    {
+        std::cout << entry.path << ": " << entry.header.continentCount << " continents, " << entry.header.territoryCount << " territories, author: " << entry.header.author
+                  << ", image: " << entry.header.image << ", hash: " << std::hex << entry.hash << std::dec << std::endl;
+    }
+    std::cout << rescannedFiles << " files read, the others came from " << MapCatalog::getIndexPath("maps") << std::endl;
+
+    std::cout << "\nMAP HOT RELOAD TEST" << std::endl;
+
+    const auto watchedPath = (std::filesystem::temp_directory_path() / "hot_reload.map").string();
+    std::filesystem::copy_file("maps/world.map", watchedPath, std::filesystem::copy_options::overwrite_existing);
+
+    // saves new contents the way editors do, into a temporary file renamed over the map
+    const auto saveMap = [&watchedPath](const std::string &contents)
+    {
+        std::ofstream(watchedPath + ".tmp", std::ios::binary) << contents;
+        std::filesystem::rename(watchedPath + ".tmp", watchedPath);
+    };
+
+    const auto waitForVersion = [&watchedPath](const MapWatcher &watcher, uint64_t version)
+    {
+        for (int i = 0; i < 200 && watcher.getVersion(watchedPath) < version; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    };
+
+    {
+        MapWatcher watcher;
+        std::cout << "watching " << watchedPath << ": " << std::boolalpha << watcher.watch(watchedPath) << std::endl;
+
+        // a game in flight holds this snapshot
+        const auto snapshot = watcher.getMap(watchedPath);
+
+        std::ifstream original("maps/world.map", std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(original)), std::istreambuf_iterator<char>());
+        contents.replace(contents.find("author=") + 7, contents.find('\n', contents.find("author=")) - contents.find("author=") - 7, "Hot Reload");
+
+        saveMap(contents);
+        waitForVersion(watcher, 2);
+
+        std::cout << "version " << watcher.getVersion(watchedPath) << ", author: " << watcher.getMap(watchedPath)->getAuthor() << " (snapshot still by " << snapshot->getAuthor() << ")" << std::endl;
+
+        // a broken edit isn't published
+        saveMap("[Territories]\nNowhere,1,1,Atlantis,Elsewhere\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        std::cout << "version " << watcher.getVersion(watchedPath) << " after a broken edit, author: " << watcher.getMap(watchedPath)->getAuthor() << std::endl;
+    }
+
+    std::filesystem::remove(watchedPath);
+    std::filesystem::remove(MapLoader::getCompiledMapPath(watchedPath));
+}
+
+void benchmarkMaps()
+{
+    std::cout << "MAP LOADING BENCHMARK" << std::endl;
+    std::cout << "maps/world.map: " << timeMapLoad("maps/world.map", 200) << " ms" << std::endl;
+
+    for (auto &&territoryCount : {1000, 10000, 100000})
+    {
+        const auto path = writeGeneratedMap(MapFamily::GRID, territoryCount);
+        const auto map = MapLoader::loadMap(path);
+
+        std::cout << map->getTerritoryCount() << " territories: " << timeMapLoad(path, territoryCount >= 100000 ? 3 : 10) << " ms" << std::endl;
+
+        std::filesystem::remove(MapLoader::getCompiledMapPath(path));
+
+        // first call parses, validates and compiles; the following ones come straight from the .mapbin
+        const auto start = std::chrono::steady_clock::now();
+        MapLoader::loadMapCached(path);
+        const auto compiled = std::chrono::steady_clock::now();
+        for (int i = 0; i < 5; i++)
+            MapLoader::loadMapCached(path);
+        const auto cached = std::chrono::steady_clock::now();
+
+        std::cout << "  load + validate + compile: " << std::chrono::duration<double, std::milli>(compiled - start).count() << " ms, cached load: " << std::chrono::duration<double, std::milli>(cached - compiled).count() / 5 << " ms" << std::endl;
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(MapLoader::getCompiledMapPath(path));
+    }
+
+    std::cout << "\nMAP LIST LOADING BENCHMARK" << std::endl;
+
+    {
+        // a tournament-sized list of large maps, loaded cold (no .mapbin) one after another and then on a thread pool
+        std::vector<std::string> paths;
+        for (size_t i = 0; i < 5; i++)
+        {
+            const auto map = MapGenerator::generate({MapFamily::RANDOM_GEOMETRIC, 50000, 500, i});
+            paths.push_back((std::filesystem::temp_directory_path() / ("tournament_" + std::to_string(i) + ".map")).string());
+            MapWriter::writeMap(*map, paths.back());
+        }
+
+        const auto removeCompiledMaps = [&paths]()
+        {
+            for (auto &&path : paths)
+                std::filesystem::remove(MapLoader::getCompiledMapPath(path));
+        };
+
+        removeCompiledMaps();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto &&path : paths)
+            MapLoader::loadMapCached(path);
+        const auto sequential = std::chrono::steady_clock::now();
+
+        removeCompiledMaps();
+        ThreadPool pool;
+        const auto poolStart = std::chrono::steady_clock::now();
+        MapLoader::loadMapsCached(paths, pool);
+        const auto parallel = std::chrono::steady_clock::now();
+
+        std::cout << paths.size() << " maps of 50000 territories: sequential " << std::chrono::duration<double, std::milli>(sequential - start).count() << " ms, "
+                  << pool.getThreadCount() << " threads " << std::chrono::duration<double, std::milli>(parallel - poolStart).count() << " ms" << std::endl;
+
+        removeCompiledMaps();
+        for (auto &&path : paths)
+            std::filesystem::remove(path);
+    }
+
+    std::cout << "\nMAP CATALOG BENCHMARK" << std::endl;
+
+    {
+        // a directory of a thousand small maps, catalogued cold, then from the index, then after one of them changed
+        const auto directory = std::filesystem::temp_directory_path() / "map_catalog";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        for (size_t i = 0; i < 1000; i++)
+            MapWriter::writeMap(*MapGenerator::generate({MapFamily::RANDOM_GEOMETRIC, 200, 6, i}), (directory / ("map_" + std::to_string(i) + ".map")).string());
+
+        size_t rescannedFiles = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto entries = MapCatalog::scanDirectory(directory.string(), &rescannedFiles);
+        const auto cold = std::chrono::steady_clock::now();
+        const auto coldFiles = rescannedFiles;
+
+        MapCatalog::scanDirectory(directory.string(), &rescannedFiles);
+        const auto indexed = std::chrono::steady_clock::now();
+        const auto indexedFiles = rescannedFiles;
+
+        MapWriter::writeMap(*MapGenerator::generate({MapFamily::GRID, 300, 6, 0}), entries.front().path);
+        const auto touched = std::chrono::steady_clock::now();
+        MapCatalog::scanDirectory(directory.string(), &rescannedFiles);
+        const auto changed = std::chrono::steady_clock::now();
+
+        std::cout << entries.size() << " maps: cold " << std::chrono::duration<double, std::milli>(cold - start).count() << " ms (" << coldFiles << " read), indexed "
+                  << std::chrono::duration<double, std::milli>(indexed - cold).count() << " ms (" << indexedFiles << " read), one changed "
+                  << std::chrono::duration<double, std::milli>(changed - touched).count() << " ms (" << rescannedFiles << " read)" << std::endl;
+
+        std::filesystem::remove_all(directory);
+    }
+
+    std::cout << "\nMAP MEMORY BENCHMARK" << std::endl;
+
+    if (!AllocationCounter::ENABLED)
+        std::cout << "Allocations aren't counted in this build (configure with -DRISK_COUNT_ALLOCATIONS=ON)" << std::endl;
+    else
+        for (auto &&territoryCount : {0, 1000, 10000, 100000})
+        {
+            // 0 stands for maps/world.map
+            const auto path = territoryCount == 0 ? std::string("maps/world.map") : writeGeneratedMap(MapFamily::GRID, territoryCount);
+
+            const AllocationCounter counter;
+            const auto map = MapLoader::loadMap(path);
+            const double territories = static_cast<double>(map->getTerritoryCount());
+
+            std::cout << path << ": " << map->getTerritoryCount() << " territories, " << counter.getAllocations() / territories << " allocations and "
+                      << counter.getLiveBytes() / territories << " bytes per territory" << std::endl;
+
+            if (territoryCount != 0)
+                std::filesystem::remove(path);
+        }
+
+    std::cout << "\nADJACENCY QUERY BENCHMARK" << std::endl;
+
+    {
+        const auto map = MapLoader::loadMap("maps/world.map");
+        const auto territoryCount = static_cast<TerritoryId>(map->getTerritoryCount());
+        const int rounds = 2000;
+        size_t adjacentPairs = 0, scannedPairs = 0, commonNeighbours = 0;
+
+        // every ordered pair of territories, through the bit-matrix and then by scanning the CSR neighbours
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++)
+            for (TerritoryId territory1 = 0; territory1 < territoryCount; territory1++)
+                for (TerritoryId territory2 = 0; territory2 < territoryCount; territory2++)
+                    adjacentPairs += Map::areAdjacent(*map, territory1, territory2);
+        const auto matrix = std::chrono::steady_clock::now();
+
+        for (int round = 0; round < rounds; round++)
+            for (TerritoryId territory1 = 0; territory1 < territoryCount; territory1++)
+            {
+                const auto neighbours = Map::getAdjacentTerritoryIds(*map, territory1);
+                for (TerritoryId territory2 = 0; territory2 < territoryCount; territory2++)
+                    scannedPairs += std::find(neighbours.begin(), neighbours.end(), territory2) != neighbours.end();
+            }
+        const auto scan = std::chrono::steady_clock::now();
+
+        for (int round = 0; round < rounds; round++)
+            for (TerritoryId territory1 = 0; territory1 < territoryCount; territory1++)
+                for (TerritoryId territory2 = 0; territory2 < territoryCount; territory2++)
+                    commonNeighbours += Map::countCommonNeighbours(*map, territory1, territory2);
+        const auto common = std::chrono::steady_clock::now();
+
+        const double queries = static_cast<double>(rounds) * territoryCount * territoryCount;
+
+        std::cout << "maps/world.map (bit-matrix: " << std::boolalpha << Map::hasAdjacencyMatrix(*map) << "): areAdjacent "
+                  << std::chrono::duration<double, std::nano>(matrix - start).count() / queries << " ns, CSR scan "
+                  << std::chrono::duration<double, std::nano>(scan - matrix).count() / queries << " ns, countCommonNeighbours "
+                  << std::chrono::duration<double, std::nano>(common - scan).count() / queries << " ns per query ("
+                  << adjacentPairs / rounds << " / " << scannedPairs / rounds << " adjacent pairs, " << commonNeighbours / rounds << " common neighbours)" << std::endl;
+    }
+
+    std::cout << "\nNEIGHBOUR QUERY BENCHMARK" << std::endl;
+
+    {
+        const auto map = MapLoader::loadMap("maps/world.map");
+        const auto territories = Map::getAllTerritories(*map);
+        const int rounds = 20000;
+        const double queries = static_cast<double>(rounds) * territories.size();
+        size_t neighbours = 0;
+
+        // how the strategies used to walk neighbours (lookup by name, vector built per call), then through the non-owning view
+        AllocationCounter byNameCounter;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++)
+            for (auto &&territory : territories)
+                for (auto &&neighbour : Map::getAdjacentTerritories(*map, territory->getName()))
+                    neighbours += neighbour->getX() > 0;
+        const auto byName = std::chrono::steady_clock::now();
+        const auto byNameAllocations = byNameCounter.getAllocations();
+
+        AllocationCounter viewCounter;
+        for (int round = 0; round < rounds; round++)
+            for (auto &&territory : territories)
+                for (auto &&neighbour : Map::getNeighbours(*map, *territory))
+                    neighbours += neighbour->getX() > 0;
+        const auto view = std::chrono::steady_clock::now();
+        const auto viewAllocations = viewCounter.getAllocations();
+
+        // allocations only when they're counted (see AllocationCounter)
+        std::cout << "getAdjacentTerritories by name: " << std::chrono::duration<double, std::nano>(byName - start).count() / queries << " ns";
+        if (AllocationCounter::ENABLED)
+            std::cout << " and " << byNameAllocations / queries << " allocations";
+        std::cout << " per query" << std::endl;
+        std::cout << "getNeighbours: " << std::chrono::duration<double, std::nano>(view - byName).count() / queries << " ns";
+        if (AllocationCounter::ENABLED)
+            std::cout << " and " << viewAllocations / queries << " allocations";
+        std::cout << " per query (" << neighbours / (2 * rounds) << " neighbours)" << std::endl;
+    }
+
+    std::cout << "\nDISTANCE QUERY BENCHMARK" << std::endl;
+
+    for (auto &&territoryCount : {0, 2000, 100000})
+    {
+        // 0 stands for maps/world.map; the largest map is past MAX_DISTANCE_MATRIX_TERRITORIES, so it goes through the cached BFS rows
+        const auto map = territoryCount == 0 ? MapLoader::loadMap("maps/world.map") : MapGenerator::generate({MapFamily::RANDOM_GEOMETRIC, static_cast<size_t>(territoryCount), static_cast<size_t>(territoryCount / 100), 42});
+        const auto territories = static_cast<TerritoryId>(map->getTerritoryCount());
+        const int queries = 1000000;
+        uint64_t totalDistance = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        Map::distance(*map, 0, territories - 1);
+        const auto warmedUp = std::chrono::steady_clock::now();
+
+        // sources are drawn from a few hot territories (like a player's frontier), targets from the whole map
+        for (int i = 0; i < queries; i++)
+            totalDistance += Map::distance(*map, static_cast<TerritoryId>(i % 8 * (territories / 8)), static_cast<TerritoryId>((i * 7919ull) % territories));
+        const auto queried = std::chrono::steady_clock::now();
+
+        std::cout << map->getTerritoryCount() << " territories: warm-up " << std::chrono::duration<double, std::milli>(warmedUp - start).count() << " ms, "
+                  << std::chrono::duration<double, std::nano>(queried - warmedUp).count() / queries << " ns per query (average distance "
+                  << static_cast<double>(totalDistance) / queries << ")" << std::endl;
+    }
+
+    std::cout << "\nSPATIAL QUERY BENCHMARK" << std::endl;
+
+    for (auto &&territoryCount : {2000, 100000})
+    {
+        const auto map = MapGenerator::generate({MapFamily::RANDOM_GEOMETRIC, static_cast<size_t>(territoryCount), static_cast<size_t>(territoryCount / 100), 42});
+        const auto territories = Map::getAllTerritories(*map);
+        const int queries = 2000;
+        std::vector<TerritoryId> nearest;
+        size_t mismatches = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++)
+        {
+            const auto *territory = territories[(i * 7919ull) % territories.size()];
+            Map::getNearestTerritoryIds(*map, territory->getX() + 3, territory->getY() - 3, 8, nearest);
+        }
+        const auto indexed = std::chrono::steady_clock::now();
+
+        // the same queries by scanning every territory, checking the index agrees on the nearest one
+        for (int i = 0; i < queries; i++)
+        {
+            const auto *territory = territories[(i * 7919ull) % territories.size()];
+            const int64_t x = territory->getX() + 3, y = territory->getY() - 3;
+            std::pair<int64_t, TerritoryId> closest(std::numeric_limits<int64_t>::max(), INVALID_TERRITORY_ID);
+
+            for (auto &&other : territories)
+                closest = std::min(closest, std::make_pair((other->getX() - x) * (other->getX() - x) + (other->getY() - y) * (other->getY() - y), other->getId()));
+
+            mismatches += closest.second != Map::getNearestTerritoryId(*map, static_cast<int32_t>(x), static_cast<int32_t>(y));
+        }
+        const auto scanned = std::chrono::steady_clock::now();
+
+        std::cout << map->getTerritoryCount() << " territories, 8 nearest: " << std::chrono::duration<double, std::micro>(indexed - start).count() / queries << " us with the grid, "
+                  << std::chrono::duration<double, std::micro>(scanned - indexed).count() / queries << " us scanning (" << mismatches << " mismatches)" << std::endl;
+    }
+
+    std::cout << "\nMAP GENERATION BENCHMARK" << std::endl;
+
+    for (auto &&family : {MapFamily::GRID, MapFamily::CONTINENT_RING, MapFamily::RANDOM_GEOMETRIC, MapFamily::SCALE_FREE})
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto map = MapGenerator::generate({family, 100000, 1000, 42});
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << family << ", " << map->getTerritoryCount() << " territories: " << elapsed << " ms (" << map->getValidity() << ")" << std::endl;
+    }
+
+    std::cout << "\nMAP VALIDATION BENCHMARK" << std::endl;
+
+    for (auto &&territoryCount : {10000, 100000, 1000000, 2000000})
+    {
+        const auto map = MapGenerator::generate({MapFamily::GRID, static_cast<size_t>(territoryCount), static_cast<size_t>(territoryCount / 100), 42});
+
+        const auto start = std::chrono::steady_clock::now();
+        Map::validate(map.get());
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << map->getTerritoryCount() << " territories: " << elapsed << " ms (" << elapsed * 1e6 / map->getTerritoryCount() << " ns per territory, " << map->getValidity() << ")" << std::endl;
+    }
+}
@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+#include "MapGenerator.h"
+
+std::ostream &operator<<(std::ostream &os, const MapFamily &family)
+{
+    switch (family)
+    {
+    case MapFamily::GRID:
+        os << "Grid";
+        break;
+
+    case MapFamily::CONTINENT_RING:
+        os << "Continent Ring";
+        break;
+
+    case MapFamily::RANDOM_GEOMETRIC:
+        os << "Random Geometric";
+        break;
+
+    case MapFamily::SCALE_FREE:
+        os << "Scale-Free";
+        break;
+    }
+
+    return os;
+}
+
+// random numbers are drawn straight from the engine (not through std:: distributions), so a seed gives the same map with every standard library
+static size_t randomIndex(std::mt19937_64 &rng, size_t count)
+{
+    return static_cast<size_t>(rng() % count);
+}
+
+static double randomUnit(std::mt19937_64 &rng)
+{
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+}
+
+// continents own contiguous ranges of territory IDs of (almost) equal size
+static size_t getContinentBegin(size_t continent, size_t territoryCount, size_t continentCount)
+{
+    return continent * territoryCount / continentCount;
+}
+
+// side of the square the territories are placed in, so maps of any size keep distinct coordinates in a uint16_t
+static double getCanvasSize(size_t territoryCount)
+{
+    return std::clamp(std::sqrt(static_cast<double>(territoryCount)) * 50.0, 100.0, 65000.0);
+}
+
+static uint16_t toCoordinate(double position, double canvasSize)
+{
+    return static_cast<uint16_t>(std::clamp(position * canvasSize, 0.0, 65535.0));
+}
+
+// union-find with path halving, used to stitch disconnected pieces of a continent together
+static TerritoryId findRoot(std::vector<TerritoryId> &parents, TerritoryId territory)
+{
+    while (parents[territory] != territory)
+    {
+        parents[territory] = parents[parents[territory]];
+        territory = parents[territory];
+    }
+
+    return territory;
+}
+
+std::shared_ptr<Map> MapGenerator::generate(const MapGeneratorOptions &options)
+{
+    std::shared_ptr<Map> map = std::make_shared<Map>();
+
+    MapGeneratorOptions clampedOptions = options;
+    clampedOptions.territoryCount = std::min<size_t>(options.territoryCount, INVALID_TERRITORY_ID);
+    clampedOptions.continentCount = std::clamp<size_t>(options.continentCount, 1, std::max<size_t>(clampedOptions.territoryCount, 1));
+
+    if (clampedOptions.territoryCount == 0)
+    {
+        Map::validate(map.get());
+        return map;
+    }
+
+    std::mt19937_64 rng(options.seed);
+    std::vector<ContinentId> continentOf;
+    std::vector<std::pair<uint16_t, uint16_t>> positions;
+    EdgeList edges;
+
+    continentOf.reserve(clampedOptions.territoryCount);
+    positions.reserve(clampedOptions.territoryCount);
+
+    switch (options.family)
+    {
+    case MapFamily::GRID:
+        generateGrid(clampedOptions, continentOf, positions, edges);
+        break;
+
+    case MapFamily::CONTINENT_RING:
+        generateContinentRing(clampedOptions, continentOf, positions, edges, rng);
+        break;
+
+    case MapFamily::RANDOM_GEOMETRIC:
+        generateRandomGeometric(clampedOptions, continentOf, positions, edges, rng);
+        break;
+
+    case MapFamily::SCALE_FREE:
+        generateScaleFree(clampedOptions, continentOf, positions, edges, rng);
+        break;
+    }
+
+    std::ostringstream author;
+    author << "MapGenerator (" << options.family << ", seed " << options.seed << ")";
+    *map->author = author.str();
+    *map->image = "none";
+
+    // the families may clamp the continent count further (e.g. a grid has at most one continent per row)
+    const size_t continentCount = continentOf.empty() ? 0 : static_cast<size_t>(continentOf.back()) + 1;
+    std::vector<size_t> continentSizes(continentCount, 0);
+    for (auto continent : continentOf)
+        continentSizes[continent]++;
+
+    map->continentIds.reserve(continentCount);
+    map->continentsById.reserve(continentCount);
+
+    for (size_t continent = 0; continent < continentCount; continent++)
+    {
+        // bonus like the classic maps: roughly one army per three territories
+        const auto bonus = static_cast<uint16_t>(std::clamp<size_t>(continentSizes[continent] / 3, 1, UINT16_MAX));
+        map->addContinent("Continent " + std::to_string(continent), bonus);
+    }
+
+    map->territoryIds.reserve(continentOf.size());
+    map->territoriesById.reserve(continentOf.size());
+
+    for (size_t territory = 0; territory < continentOf.size(); territory++)
+    {
+        map->addTerritory("Territory " + std::to_string(territory), positions[territory].first, positions[territory].second, continentOf[territory]);
+    }
+
+    buildAdjacency(*map, edges);
+    map->buildIndexes();
+    Map::validate(map.get());
+
+    return map;
+}
+
+bool MapGenerator::getFamilyFromString(std::string_view familyString, MapFamily &family)
+{
+    if (familyString == "grid")
+        family = MapFamily::GRID;
+    else if (familyString == "ring")
+        family = MapFamily::CONTINENT_RING;
+    else if (familyString == "geometric")
+        family = MapFamily::RANDOM_GEOMETRIC;
+    else if (familyString == "scalefree")
+        family = MapFamily::SCALE_FREE;
+    else
+        return false;
+
+    return true;
+}
+
+void MapGenerator::generateGrid(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges)
+{
+    // 4-neighbour grid filled row by row, continents are horizontal strips of whole rows (the last row may be partial)
+    const size_t territoryCount = options.territoryCount;
+    const auto width = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(territoryCount))));
+    const size_t rows = (territoryCount + width - 1) / width;
+    const size_t continentCount = std::min(options.continentCount, rows);
+    const double spacing = getCanvasSize(territoryCount) / static_cast<double>(width);
+
+    edges.reserve(territoryCount * 2);
+
+    for (size_t territory = 0; territory < territoryCount; territory++)
+    {
+        const size_t row = territory / width, column = territory % width;
+
+        continentOf.push_back(static_cast<ContinentId>(row * continentCount / rows));
+        positions.emplace_back(toCoordinate(column * spacing + spacing / 2, 1.0), toCoordinate(row * spacing + spacing / 2, 1.0));
+
+        if (column > 0)
+            edges.emplace_back(territory - 1, territory);
+
+        if (row > 0)
+            edges.emplace_back(territory - width, territory);
+    }
+}
+
+void MapGenerator::generateContinentRing(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges, std::mt19937_64 &rng)
+{
+    // each continent is a cycle with a few random chords, sitting on a big circle and linked to the next continent around it
+    const size_t territoryCount = options.territoryCount, continentCount = options.continentCount;
+    const double canvasSize = getCanvasSize(territoryCount);
+    const double pi = std::acos(-1.0);
+
+    edges.reserve(territoryCount + territoryCount / 4 + continentCount);
+
+    for (size_t continent = 0; continent < continentCount; continent++)
+    {
+        const size_t begin = getContinentBegin(continent, territoryCount, continentCount);
+        const size_t end = getContinentBegin(continent + 1, territoryCount, continentCount);
+        const size_t size = end - begin;
+
+        const double continentAngle = 2 * pi * continent / continentCount;
+        const double centreX = 0.5 + 0.35 * std::cos(continentAngle), centreY = 0.5 + 0.35 * std::sin(continentAngle);
+        const double radius = continentCount > 1 ? std::min(0.12, 0.9 * std::sin(pi / continentCount) * 0.35) : 0.4;
+
+        for (size_t territory = begin; territory < end; territory++)
+        {
+            const double angle = 2 * pi * (territory - begin) / size;
+
+            continentOf.push_back(static_cast<ContinentId>(continent));
+            positions.emplace_back(toCoordinate(centreX + radius * std::cos(angle), canvasSize), toCoordinate(centreY + radius * std::sin(angle), canvasSize));
+
+            if (territory > begin)
+                edges.emplace_back(territory - 1, territory);
+        }
+
+        if (size > 2)
+            edges.emplace_back(end - 1, begin);
+
+        for (size_t chord = 0; size > 3 && chord < size / 4; chord++)
+            edges.emplace_back(begin + randomIndex(rng, size), begin + randomIndex(rng, size));
+
+        // links to the next continent (the last one closes the ring)
+        if (continentCount > 1 && (continent + 1 < continentCount || continentCount > 2))
+        {
+            const size_t next = (continent + 1) % continentCount;
+            const size_t nextBegin = getContinentBegin(next, territoryCount, continentCount);
+            const size_t nextSize = getContinentBegin(next + 1, territoryCount, continentCount) - nextBegin;
+
+            edges.emplace_back(begin + randomIndex(rng, size), nextBegin + randomIndex(rng, nextSize));
+        }
+    }
+}
+
+void MapGenerator::generateRandomGeometric(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges, std::mt19937_64 &rng)
+{
+    // points spread uniformly over the unit square, neighbours when closer than a radius giving ~6 neighbours on average;
+    // IDs follow the x coordinate, so continents are vertical strips
+    const size_t territoryCount = options.territoryCount, continentCount = options.continentCount;
+    const double canvasSize = getCanvasSize(territoryCount);
+    const double radius = std::min(1.0, std::sqrt(6.0 / (std::acos(-1.0) * territoryCount)));
+
+    std::vector<std::pair<double, double>> points(territoryCount);
+    for (auto &&point : points)
+    {
+        point.first = randomUnit(rng);
+        point.second = randomUnit(rng);
+    }
+
+    std::sort(points.begin(), points.end());
+
+    for (size_t territory = 0; territory < territoryCount; territory++)
+    {
+        continentOf.push_back(static_cast<ContinentId>(territory * continentCount / territoryCount));
+        positions.emplace_back(toCoordinate(points[territory].first, canvasSize), toCoordinate(points[territory].second, canvasSize));
+    }
+
+    // bucket the points in cells of the radius' size, so only the 3x3 surrounding cells are searched for neighbours
+    const auto cellsPerSide = std::max<size_t>(1, static_cast<size_t>(1.0 / radius));
+    const auto getCell = [cellsPerSide](double coordinate)
+    { return std::min(cellsPerSide - 1, static_cast<size_t>(coordinate * cellsPerSide)); };
+
+    std::vector<uint32_t> cellOffsets(cellsPerSide * cellsPerSide + 1, 0);
+    std::vector<TerritoryId> cellTerritories(territoryCount);
+
+    for (auto &&point : points)
+        cellOffsets[getCell(point.second) * cellsPerSide + getCell(point.first) + 1]++;
+
+    std::partial_sum(cellOffsets.begin(), cellOffsets.end(), cellOffsets.begin());
+
+    std::vector<uint32_t> cellFill(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+        cellTerritories[cellFill[getCell(points[territory].second) * cellsPerSide + getCell(points[territory].first)]++] = territory;
+
+    std::vector<TerritoryId> parents(territoryCount);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    edges.reserve(territoryCount * 4);
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+    {
+        const size_t cellX = getCell(points[territory].first), cellY = getCell(points[territory].second);
+
+        for (size_t y = cellY > 0 ? cellY - 1 : 0; y <= std::min(cellY + 1, cellsPerSide - 1); y++)
+        {
+            for (size_t x = cellX > 0 ? cellX - 1 : 0; x <= std::min(cellX + 1, cellsPerSide - 1); x++)
+            {
+                const size_t cell = y * cellsPerSide + x;
+
+                for (auto i = cellOffsets[cell]; i < cellOffsets[cell + 1]; i++)
+                {
+                    const auto other = cellTerritories[i];
+                    const double dx = points[territory].first - points[other].first, dy = points[territory].second - points[other].second;
+
+                    if (other <= territory || dx * dx + dy * dy > radius * radius)
+                        continue;
+
+                    edges.emplace_back(territory, other);
+
+                    if (continentOf[territory] == continentOf[other])
+                        parents[findRoot(parents, territory)] = findRoot(parents, other);
+                }
+            }
+        }
+    }
+
+    // stitch each continent's pieces together in x order, then chain neighbouring strips
+    for (TerritoryId territory = 1; territory < territoryCount; territory++)
+    {
+        if (continentOf[territory] != continentOf[territory - 1])
+        {
+            edges.emplace_back(territory - 1, territory);
+            continue;
+        }
+
+        const auto root = findRoot(parents, territory), previousRoot = findRoot(parents, territory - 1);
+
+        if (root != previousRoot)
+        {
+            edges.emplace_back(territory - 1, territory);
+            parents[root] = previousRoot;
+        }
+    }
+}
+
+void MapGenerator::generateScaleFree(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges, std::mt19937_64 &rng)
+{
+    // Barabási–Albert growth inside each continent (every new territory attaches to two existing ones, picked in proportion to
+    // their degree), then each continent links a hub-biased territory to one in a random earlier continent
+    const size_t territoryCount = options.territoryCount, continentCount = options.continentCount;
+    const double canvasSize = getCanvasSize(territoryCount);
+    const auto blocksPerSide = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(continentCount))));
+
+    // every edge endpoint of a continent, so a uniform pick from it is a degree-proportional pick of a territory
+    std::vector<std::vector<TerritoryId>> endpoints(continentCount);
+
+    edges.reserve(territoryCount * 2 + continentCount);
+
+    for (size_t continent = 0; continent < continentCount; continent++)
+    {
+        const size_t begin = getContinentBegin(continent, territoryCount, continentCount);
+        const size_t end = getContinentBegin(continent + 1, territoryCount, continentCount);
+        const double blockX = static_cast<double>(continent % blocksPerSide) / blocksPerSide;
+        const double blockY = static_cast<double>(continent / blocksPerSide) / blocksPerSide;
+        auto &continentEndpoints = endpoints[continent];
+
+        continentEndpoints.reserve((end - begin) * 4);
+
+        for (size_t territory = begin; territory < end; territory++)
+        {
+            continentOf.push_back(static_cast<ContinentId>(continent));
+            positions.emplace_back(toCoordinate(blockX + randomUnit(rng) / blocksPerSide, canvasSize), toCoordinate(blockY + randomUnit(rng) / blocksPerSide, canvasSize));
+
+            const auto id = static_cast<TerritoryId>(territory);
+
+            if (territory == begin)
+                continue;
+
+            // the second territory (and any degenerate start) just links to the first
+            if (continentEndpoints.empty())
+            {
+                edges.emplace_back(begin, id);
+                continentEndpoints.push_back(static_cast<TerritoryId>(begin));
+                continentEndpoints.push_back(id);
+                continue;
+            }
+
+            const auto first = continentEndpoints[randomIndex(rng, continentEndpoints.size())];
+            auto second = continentEndpoints[randomIndex(rng, continentEndpoints.size())];
+
+            edges.emplace_back(first, id);
+            continentEndpoints.push_back(first);
+            continentEndpoints.push_back(id);
+
+            if (second != first)
+            {
+                edges.emplace_back(second, id);
+                continentEndpoints.push_back(second);
+                continentEndpoints.push_back(id);
+            }
+        }
+
+        if (continent == 0)
+            continue;
+
+        const size_t other = randomIndex(rng, continent);
+        const auto pick = [&](size_t pickedContinent)
+        {
+            const auto &pickedEndpoints = endpoints[pickedContinent];
+            if (pickedEndpoints.empty())
+                return static_cast<TerritoryId>(getContinentBegin(pickedContinent, territoryCount, continentCount));
+
+            return pickedEndpoints[randomIndex(rng, pickedEndpoints.size())];
+        };
+
+        edges.emplace_back(pick(continent), pick(other));
+    }
+}
+
+void MapGenerator::buildAdjacency(Map &map, EdgeList &edges)
+{
+    // both directions of every edge, sorted by source then target, without self-loops or duplicates
+    const size_t edgeCount = edges.size();
+    edges.reserve(edgeCount * 2);
+
+    for (size_t i = 0; i < edgeCount; i++)
+        edges.emplace_back(edges[i].second, edges[i].first);
+
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [](const std::pair<TerritoryId, TerritoryId> &edge)
+                               { return edge.first == edge.second; }),
+                edges.end());
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    map.adjacencyOffsets.assign(map.territoriesById.size() + 1, 0);
+    map.adjacencyTargets.clear();
+    map.adjacencyTargets.reserve(edges.size());
+
+    for (auto &&edge : edges)
+    {
+        map.adjacencyOffsets[edge.first + 1]++;
+        map.adjacencyTargets.push_back(edge.second);
+    }
+
+    std::partial_sum(map.adjacencyOffsets.begin(), map.adjacencyOffsets.end(), map.adjacencyOffsets.begin());
+}
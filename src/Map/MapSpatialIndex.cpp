@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Map.h"
+
+/*
+    Spatial index over the territory coordinates.
+
+    Territories are bucketed into a uniform grid (laid out like the CSR adjacency) with about two territories per cell.
+    Rectangle queries scan the overlapped cells only; nearest-neighbour queries visit the cells ring by ring around the
+    query point's cell and stop as soon as the next ring can't hold anything closer than the k-th best so far.
+
+    A map that wraps (wrap=yes) is a cylinder along its scroll direction. The map image's size isn't known here, so a
+    wrapped axis is assumed to leave as much room past its last territory as before its first: its period is
+    min + max + 1, and the grid covers [0, period) along it.
+*/
+
+// the range of grid coordinates covered along one axis
+struct Axis
+{
+    int32_t origin;
+    int32_t extent;
+    uint32_t cells;
+    bool wraps;
+
+    // the cell of an (in-range) coordinate
+    uint32_t getCell(int32_t coordinate) const
+    {
+        return static_cast<uint32_t>(static_cast<int64_t>(coordinate - origin) * cells / extent);
+    }
+
+    // a coordinate folded into [0, extent) on a wrapped axis, unchanged otherwise
+    int32_t normalize(int32_t coordinate) const
+    {
+        if (!wraps)
+            return coordinate;
+
+        const auto folded = coordinate % extent;
+        return folded < 0 ? folded + extent : folded;
+    }
+
+    // distance between two coordinates, around the axis if it wraps (`from` normalized)
+    int64_t distance(int32_t from, int32_t to) const
+    {
+        const int64_t difference = std::abs(static_cast<int64_t>(from) - to);
+        return wraps ? std::min(difference, extent - difference) : difference;
+    }
+
+    // splits [low, high] into at most two in-range intervals (two when it wraps around the axis), returns how many
+    size_t clip(int32_t low, int32_t high, std::pair<int32_t, int32_t> intervals[2]) const
+    {
+        if (high < low)
+            return 0;
+
+        if (!wraps)
+        {
+            low = std::max(low, origin);
+            high = std::min(high, origin + extent - 1);
+
+            intervals[0] = {low, high};
+            return low <= high ? 1 : 0;
+        }
+
+        if (static_cast<int64_t>(high) - low + 1 >= extent)
+        {
+            intervals[0] = {0, extent - 1};
+            return 1;
+        }
+
+        low = normalize(low);
+        high = normalize(high);
+
+        if (low <= high)
+        {
+            intervals[0] = {low, high};
+            return 1;
+        }
+
+        intervals[0] = {low, extent - 1};
+        intervals[1] = {0, high};
+        return 2;
+    }
+
+    // the cell at `offset` from `cell`, or -1 when it falls off an unwrapped axis (or repeats a cell of a wrapped one)
+    int64_t getNeighbourCell(uint32_t cell, int64_t offset) const
+    {
+        if (wraps)
+        {
+            // every cell is reached by exactly one offset in [-(cells - 1) / 2, cells / 2]
+            if (offset < -static_cast<int64_t>((cells - 1) / 2) || offset > static_cast<int64_t>(cells / 2))
+                return -1;
+
+            return (cell + offset + cells) % cells;
+        }
+
+        const auto neighbour = static_cast<int64_t>(cell) + offset;
+        return neighbour < 0 || neighbour >= cells ? -1 : neighbour;
+    }
+
+    // how many rings it takes to reach every cell of the axis from `cell`
+    uint32_t getRingCount(uint32_t cell) const
+    {
+        return wraps ? cells / 2 : std::max(cell, cells - 1 - cell);
+    }
+};
+
+static Axis getAxis(int32_t origin, int32_t extent, uint32_t cells, bool wraps)
+{
+    return Axis{origin, extent, cells, wraps};
+}
+
+void Map::buildSpatialIndex()
+{
+    auto &index = spatialIndex;
+    const auto territoryCount = territoriesById.size();
+
+    index = SpatialIndex();
+
+    if (territoryCount == 0)
+        return;
+
+    int32_t minX = std::numeric_limits<int32_t>::max(), minY = minX, maxX = 0, maxY = 0;
+
+    for (auto &&territory : territoriesById)
+    {
+        minX = std::min<int32_t>(minX, territory.getX());
+        minY = std::min<int32_t>(minY, territory.getY());
+        maxX = std::max<int32_t>(maxX, territory.getX());
+        maxY = std::max<int32_t>(maxY, territory.getY());
+    }
+
+    index.wrapX = *wrap && *scroll == ScrollDirection::HORIZONTAL;
+    index.wrapY = *wrap && *scroll == ScrollDirection::VERTICAL;
+    index.originX = index.wrapX ? 0 : minX;
+    index.originY = index.wrapY ? 0 : minY;
+    index.width = index.wrapX ? minX + maxX + 1 : maxX - minX + 1;
+    index.height = index.wrapY ? minY + maxY + 1 : maxY - minY + 1;
+
+    // about two territories per cell, with (roughly) square cells
+    const double cells = std::max<double>(1, territoryCount / 2.0);
+    index.columns = static_cast<uint32_t>(std::clamp<double>(std::round(std::sqrt(cells * index.width / index.height)), 1, index.width));
+    index.rows = static_cast<uint32_t>(std::clamp<double>(std::ceil(cells / index.columns), 1, index.height));
+
+    const auto axisX = getAxis(index.originX, index.width, index.columns, index.wrapX);
+    const auto axisY = getAxis(index.originY, index.height, index.rows, index.wrapY);
+
+    // counting sort of the territory IDs by cell, which keeps each cell's territories in ID order
+    std::vector<uint32_t> cellOf(territoryCount);
+    index.cellOffsets.assign(static_cast<size_t>(index.columns) * index.rows + 1, 0);
+    index.cellTerritories.resize(territoryCount);
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+    {
+        const auto &t = territoriesById[territory];
+
+        cellOf[territory] = axisY.getCell(t.getY()) * index.columns + axisX.getCell(t.getX());
+        index.cellOffsets[cellOf[territory] + 1]++;
+    }
+
+    for (size_t cell = 0; cell + 1 < index.cellOffsets.size(); cell++)
+        index.cellOffsets[cell + 1] += index.cellOffsets[cell];
+
+    std::vector<uint32_t> nextSlot(index.cellOffsets.begin(), index.cellOffsets.end() - 1);
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+        index.cellTerritories[nextSlot[cellOf[territory]]++] = territory;
+}
+
+void Map::getTerritoryIdsInRect(const Map &map, int32_t left, int32_t top, int32_t right, int32_t bottom, std::vector<TerritoryId> &territories)
+{
+    const auto &index = map.spatialIndex;
+    const auto axisX = getAxis(index.originX, index.width, index.columns, index.wrapX);
+    const auto axisY = getAxis(index.originY, index.height, index.rows, index.wrapY);
+
+    territories.clear();
+
+    if (map.territoriesById.empty())
+        return;
+
+    std::pair<int32_t, int32_t> intervalsX[2], intervalsY[2];
+    const auto intervalCountX = axisX.clip(left, right, intervalsX);
+    const auto intervalCountY = axisY.clip(top, bottom, intervalsY);
+
+    for (size_t i = 0; i < intervalCountY; i++)
+    {
+        for (size_t j = 0; j < intervalCountX; j++)
+        {
+            const auto [lowX, highX] = intervalsX[j];
+            const auto [lowY, highY] = intervalsY[i];
+
+            for (auto row = axisY.getCell(lowY); row <= axisY.getCell(highY); row++)
+            {
+                for (auto column = axisX.getCell(lowX); column <= axisX.getCell(highX); column++)
+                {
+                    const auto cell = row * index.columns + column;
+
+                    for (auto k = index.cellOffsets[cell]; k < index.cellOffsets[cell + 1]; k++)
+                    {
+                        const auto territory = index.cellTerritories[k];
+                        const auto &t = map.territoriesById[territory];
+
+                        if (t.getX() >= lowX && t.getX() <= highX && t.getY() >= lowY && t.getY() <= highY)
+                            territories.push_back(territory);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(territories.begin(), territories.end());
+}
+
+void Map::getNearestTerritoryIds(const Map &map, int32_t x, int32_t y, size_t k, std::vector<TerritoryId> &territories, const std::function<bool(TerritoryId)> &accept)
+{
+    const auto &index = map.spatialIndex;
+    const auto axisX = getAxis(index.originX, index.width, index.columns, index.wrapX);
+    const auto axisY = getAxis(index.originY, index.height, index.rows, index.wrapY);
+
+    territories.clear();
+
+    if (map.territoriesById.empty() || k == 0)
+        return;
+
+    x = axisX.normalize(x);
+    y = axisY.normalize(y);
+
+    // the query's cell (the nearest one on an unwrapped axis when the point lies outside the grid)
+    const auto column = axisX.getCell(std::clamp(x, index.originX, index.originX + index.width - 1));
+    const auto row = axisY.getCell(std::clamp(y, index.originY, index.originY + index.height - 1));
+    const auto ringCount = std::max(axisX.getRingCount(column), axisY.getRingCount(row));
+
+    // every territory in ring r is at least (r - 1) cells away along one axis
+    const auto cellSize = std::min(static_cast<double>(index.width) / index.columns, static_cast<double>(index.height) / index.rows);
+
+    // max-heap of the k best (squared distance, ID) pairs so far
+    std::vector<std::pair<int64_t, TerritoryId>> best;
+    best.reserve(k + 1);
+
+    const auto visitCell = [&](int64_t cellColumn, int64_t cellRow)
+    {
+        if (cellColumn < 0 || cellRow < 0)
+            return;
+
+        const auto cell = static_cast<uint32_t>(cellRow) * index.columns + static_cast<uint32_t>(cellColumn);
+
+        for (auto i = index.cellOffsets[cell]; i < index.cellOffsets[cell + 1]; i++)
+        {
+            const auto territory = index.cellTerritories[i];
+
+            if (accept && !accept(territory))
+                continue;
+
+            const auto &t = map.territoriesById[territory];
+            const auto dx = axisX.distance(x, t.getX());
+            const auto dy = axisY.distance(y, t.getY());
+            const std::pair<int64_t, TerritoryId> candidate(dx * dx + dy * dy, territory);
+
+            if (best.size() < k)
+            {
+                best.push_back(candidate);
+                std::push_heap(best.begin(), best.end());
+            }
+            else if (candidate < best.front())
+            {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = candidate;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    };
+
+    for (int64_t ring = 0; ring <= ringCount; ring++)
+    {
+        if (best.size() == k && ring > 0)
+        {
+            const auto bound = (ring - 1) * cellSize;
+
+            if (bound * bound > static_cast<double>(best.front().first))
+                break;
+        }
+
+        // the cells at Chebyshev distance `ring` from the query's cell: two full rows, then the two side columns in between
+        for (int64_t dy = -ring; dy <= ring; dy++)
+        {
+            const auto cellRow = axisY.getNeighbourCell(row, dy);
+
+            if (dy == -ring || dy == ring)
+            {
+                for (int64_t dx = -ring; dx <= ring; dx++)
+                    visitCell(axisX.getNeighbourCell(column, dx), cellRow);
+            }
+            else
+            {
+                visitCell(axisX.getNeighbourCell(column, -ring), cellRow);
+                visitCell(axisX.getNeighbourCell(column, ring), cellRow);
+            }
+
+            if (ring == 0)
+                break;
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+
+    for (auto &&entry : best)
+        territories.push_back(entry.second);
+}
+
+TerritoryId Map::getNearestTerritoryId(const Map &map, int32_t x, int32_t y, const std::function<bool(TerritoryId)> &accept)
+{
+    std::vector<TerritoryId> nearest;
+    Map::getNearestTerritoryIds(map, x, y, 1, nearest, accept);
+
+    return nearest.empty() ? INVALID_TERRITORY_ID : nearest.front();
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+
+#include "Map.h"
+
+/*
+    Graph topology, computed once per map by buildIndexes().
+
+    Articulation points and bridges come from a single Tarjan low-link DFS over the undirected closure of the adjacency
+    (an edge listed in one direction only still connects its territories), with an explicit stack so long chains don't
+    overflow the call stack. Border territories and entry points follow from one pass over the CSR adjacency, and are
+    laid out per continent like the membership index, so every accessor is a lookup.
+*/
+
+// the undirected closure of the adjacency as a CSR without self-loops or duplicate edges
+static void buildUndirectedAdjacency(const Map &map, std::vector<uint32_t> &offsets, std::vector<TerritoryId> &targets)
+{
+    const auto territoryCount = map.getTerritoryCount();
+    std::vector<std::pair<TerritoryId, TerritoryId>> edges;
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+    {
+        for (auto &&neighbour : Map::getAdjacentTerritoryIds(map, territory))
+        {
+            if (neighbour == territory)
+                continue;
+
+            edges.emplace_back(territory, neighbour);
+            edges.emplace_back(neighbour, territory);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    offsets.assign(territoryCount + 1, 0);
+    targets.resize(edges.size());
+
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        offsets[edges[i].first + 1]++;
+        targets[i] = edges[i].second;
+    }
+
+    for (size_t territory = 0; territory < territoryCount; territory++)
+        offsets[territory + 1] += offsets[territory];
+}
+
+void Map::buildTopology()
+{
+    const auto territoryCount = territoriesById.size();
+
+    topologyFlags.assign(territoryCount, 0);
+    articulationPoints.clear();
+    bridges.clear();
+
+    // articulation points and bridges: discovery[t] is t's DFS preorder number (0 until visited), low[t] the smallest
+    // discovery number reachable from t's DFS subtree through a single back edge
+    std::vector<uint32_t> offsets;
+    std::vector<TerritoryId> targets;
+    buildUndirectedAdjacency(*this, offsets, targets);
+
+    std::vector<uint32_t> discovery(territoryCount, 0), low(territoryCount, 0), nextEdge(territoryCount, 0);
+    std::vector<TerritoryId> parent(territoryCount, INVALID_TERRITORY_ID);
+    std::vector<TerritoryId> stack;
+    uint32_t clock = 0;
+
+    for (TerritoryId root = 0; root < territoryCount; root++)
+    {
+        if (discovery[root] != 0)
+            continue;
+
+        size_t rootChildren = 0;
+
+        discovery[root] = low[root] = ++clock;
+        nextEdge[root] = offsets[root];
+        stack.push_back(root);
+
+        while (!stack.empty())
+        {
+            const auto territory = stack.back();
+
+            if (nextEdge[territory] < offsets[territory + 1])
+            {
+                const auto neighbour = targets[nextEdge[territory]++];
+
+                if (discovery[neighbour] == 0)
+                {
+                    parent[neighbour] = territory;
+                    discovery[neighbour] = low[neighbour] = ++clock;
+                    nextEdge[neighbour] = offsets[neighbour];
+                    stack.push_back(neighbour);
+
+                    if (territory == root)
+                        rootChildren++;
+                }
+                else if (neighbour != parent[territory])
+                {
+                    low[territory] = std::min(low[territory], discovery[neighbour]);
+                }
+
+                continue;
+            }
+
+            // every edge of `territory` is explored, fold its low-link into its parent's
+            stack.pop_back();
+
+            const auto above = parent[territory];
+            if (above == INVALID_TERRITORY_ID)
+                continue;
+
+            low[above] = std::min(low[above], low[territory]);
+
+            if (low[territory] > discovery[above])
+                bridges.emplace_back(std::min(above, territory), std::max(above, territory));
+
+            // the root is handled once its whole tree is explored: it's a cut only if it has several DFS children
+            if (above != root && low[territory] >= discovery[above])
+                topologyFlags[above] |= TOPOLOGY_ARTICULATION_POINT;
+        }
+
+        if (rootChildren > 1)
+            topologyFlags[root] |= TOPOLOGY_ARTICULATION_POINT;
+    }
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+    {
+        if (topologyFlags[territory] & TOPOLOGY_ARTICULATION_POINT)
+            articulationPoints.push_back(territory);
+    }
+
+    std::sort(bridges.begin(), bridges.end());
+
+    // border territories, in continent then ID order since the members are listed that way
+    borderOffsets.assign(1, 0);
+    borderTerritories.clear();
+
+    for (ContinentId continent = 0; continent < continentsById.size(); continent++)
+    {
+        for (auto &&member : Map::getTerritoryIdsInContinent(*this, continent))
+        {
+            for (auto &&neighbour : Map::getAdjacentTerritoryIds(*this, member))
+            {
+                if (continentOfTerritory[neighbour] != continent)
+                {
+                    topologyFlags[member] |= TOPOLOGY_BORDER;
+                    borderTerritories.push_back(member);
+                    break;
+                }
+            }
+        }
+
+        borderOffsets.push_back(static_cast<uint32_t>(borderTerritories.size()));
+    }
+
+    // entry points: every (continent, outsider) pair that crosses into the continent, sorted and deduplicated
+    std::vector<std::pair<ContinentId, TerritoryId>> entries;
+
+    for (TerritoryId territory = 0; territory < territoryCount; territory++)
+    {
+        for (auto &&neighbour : Map::getAdjacentTerritoryIds(*this, territory))
+        {
+            if (continentOfTerritory[neighbour] != continentOfTerritory[territory])
+                entries.emplace_back(continentOfTerritory[neighbour], territory);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    entryPointOffsets.assign(continentsById.size() + 1, 0);
+    entryPoints.resize(entries.size());
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        entryPointOffsets[entries[i].first + 1]++;
+        entryPoints[i] = entries[i].second;
+    }
+
+    for (size_t continent = 0; continent < continentsById.size(); continent++)
+        entryPointOffsets[continent + 1] += entryPointOffsets[continent];
+}
+
+bool Map::isArticulationPoint(const Map &map, TerritoryId territory)
+{
+    return map.topologyFlags[territory] & TOPOLOGY_ARTICULATION_POINT;
+}
+
+TerritoryIdRange Map::getArticulationPoints(const Map &map)
+{
+    const auto *points = map.articulationPoints.data();
+
+    return TerritoryIdRange{points, points + map.articulationPoints.size()};
+}
+
+const std::vector<std::pair<TerritoryId, TerritoryId>> &Map::getBridges(const Map &map)
+{
+    return map.bridges;
+}
+
+bool Map::isBridge(const Map &map, TerritoryId territory1, TerritoryId territory2)
+{
+    return std::binary_search(map.bridges.begin(), map.bridges.end(), std::make_pair(std::min(territory1, territory2), std::max(territory1, territory2)));
+}
+
+bool Map::isBorderTerritory(const Map &map, TerritoryId territory)
+{
+    return map.topologyFlags[territory] & TOPOLOGY_BORDER;
+}
+
+TerritoryIdRange Map::getBorderTerritoryIds(const Map &map, ContinentId continent)
+{
+    const auto *borders = map.borderTerritories.data();
+
+    return TerritoryIdRange{borders + map.borderOffsets[continent], borders + map.borderOffsets[continent + 1]};
+}
+
+TerritoryRange Map::getBorderTerritories(const Map &map, ContinentId continent)
+{
+    return TerritoryRange(Map::getBorderTerritoryIds(map, continent), map.territoriesById.data());
+}
+
+TerritoryIdRange Map::getEntryPointIds(const Map &map, ContinentId continent)
+{
+    const auto *entries = map.entryPoints.data();
+
+    return TerritoryIdRange{entries + map.entryPointOffsets[continent], entries + map.entryPointOffsets[continent + 1]};
+}
+
+TerritoryRange Map::getEntryPoints(const Map &map, ContinentId continent)
+{
+    return TerritoryRange(Map::getEntryPointIds(map, continent), map.territoriesById.data());
+}
@@ -0,0 +1,154 @@
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "MapWatcher.h"
+
+MapWatcher::MapWatcher()
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (inotifyFd == -1 || pipe2(wakeFds, O_CLOEXEC) == -1)
+    {
+        std::cout << "Map hot reload unavailable: inotify could not be initialised" << std::endl;
+        return;
+    }
+
+    thread = std::thread(&MapWatcher::work, this);
+}
+
+MapWatcher::~MapWatcher()
+{
+    if (thread.joinable())
+    {
+        const char wake = 0;
+        (void)!write(wakeFds[1], &wake, 1);
+        thread.join();
+    }
+
+    for (auto fd : {inotifyFd, wakeFds[0], wakeFds[1]})
+    {
+        if (fd != -1)
+            close(fd);
+    }
+}
+
+bool MapWatcher::watch(const std::string &path)
+{
+    if (!thread.joinable())
+        return false;
+
+    // watching a path again changes nothing: its entry (which the thread may be reloading) stays as it is
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (maps.count(path) != 0)
+            return true;
+    }
+
+    const auto map = MapLoader::loadMapCached(path);
+    if (map->getValidity() != MapValidity::VALID)
+        return false;
+
+    auto watched = std::make_unique<WatchedMap>();
+    watched->path = path;
+    watched->hash = MapLoader::hashMapFile(path);
+    watched->version = 1;
+    std::atomic_store(&watched->map, std::shared_ptr<const Map>(map));
+
+    // the directory is watched rather than the file, so that files replaced by a rename (as most editors save) are seen
+    const auto directory = std::filesystem::path(path).parent_path();
+    const auto wd = inotify_add_watch(inotifyFd, directory.empty() ? "." : directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    if (wd == -1)
+        return false;
+
+    // emplace, not assign: another thread may have watched the same path meanwhile, and its entry must stay
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    directories[wd] = directory.string();
+    maps.emplace(path, std::move(watched));
+
+    return true;
+}
+
+std::shared_ptr<const Map> MapWatcher::getMap(const std::string &path) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    const auto watched = maps.find(path);
+    return watched == maps.end() ? nullptr : std::atomic_load(&watched->second->map);
+}
+
+uint64_t MapWatcher::getVersion(const std::string &path) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    const auto watched = maps.find(path);
+    return watched == maps.end() ? 0 : watched->second->version.load();
+}
+
+void MapWatcher::work()
+{
+    alignas(inotify_event) char buffer[16 * 1024];
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+
+    while (true)
+    {
+        if (poll(fds, 2, -1) == -1)
+            continue; // interrupted by a signal
+
+        if (fds[1].revents != 0)
+            return;
+
+        // every pending event is drained first, so a save that raises several events reloads its file once
+        std::unordered_set<WatchedMap *> changed;
+
+        for (ssize_t length; (length = read(inotifyFd, buffer, sizeof(buffer))) > 0;)
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+
+            for (auto *event = buffer; event < buffer + length; event += sizeof(inotify_event) + reinterpret_cast<inotify_event *>(event)->len)
+            {
+                const auto *notification = reinterpret_cast<inotify_event *>(event);
+                const auto directory = directories.find(notification->wd);
+
+                if (notification->len == 0 || directory == directories.end())
+                    continue;
+
+                const auto watched = maps.find((std::filesystem::path(directory->second) / notification->name).string());
+                if (watched != maps.end())
+                    changed.insert(watched->second.get());
+            }
+        }
+
+        // entries are never removed, so the pointers outlive the lock
+        for (auto *watched : changed)
+            reload(*watched);
+    }
+}
+
+void MapWatcher::reload(WatchedMap &watched)
+{
+    const auto hash = MapLoader::hashMapFile(watched.path);
+
+    if (hash == 0 || hash == watched.hash)
+        return;
+
+    const auto map = MapLoader::loadMapCached(watched.path);
+
+    // an edit that breaks the map keeps the last valid version in place
+    if (map->getValidity() != MapValidity::VALID)
+    {
+        std::cout << "Kept version " << watched.version << " of " << watched.path << ": the changed map is " << map->getValidity() << std::endl;
+        return;
+    }
+
+    watched.hash = hash;
+    std::atomic_store(&watched.map, std::shared_ptr<const Map>(map));
+    watched.version++;
+}
@@ -12,6 +12,20 @@
 
 using namespace std;
 
+// the stream an order's messages go to: its issuer's game's output, or nullptr when the game discards them
+static ostream *getOutput(const Player *issuer)
+{
+    const GameState *game = issuer == nullptr ? nullptr : issuer->getGame();
+    return (game == nullptr ? OutputSink::console() : game->getOutput()).getStream();
+}
+
+// whether an order goes to the game log: unless its issuer's game has the log turned off (see GameState::setLogged)
+static bool isLogged(const Player *issuer)
+{
+    const GameState *game = issuer == nullptr ? nullptr : issuer->getGame();
+    return game == nullptr || game->isLogged();
+}
+
 /**Prameterized constructor*/
 OrdersList::OrdersList(vector<Order *> list)
 {
@@ -98,7 +112,8 @@ void OrdersList::add(Order *o)
 {
     this->list.push_back(o);
     // Calls in the log file that the order has been added to the list.
-    Notify(this);
+    if (isLogged(o->issuer))
+        Notify(this);
 }
 
 std::string OrdersList::stringToLog() const
@@ -237,7 +252,8 @@ bool Advance::validate()
         Map::areAdjacent(*map, *source_terr, *dest_terr))
         return true;
 
-    cout << this->name << " order invalid." << std::endl;
+    if (ostream *out = getOutput(this->issuer))
+        *out << this->name << " order invalid.\n";
     return false;
 }
 
@@ -250,18 +266,20 @@ void Advance::execute()
             this->issuer->addTerritory(const_cast<Territory *>(this->dest_terr));
             this->issuer->setTerritoryUnits(this->dest_terr, this->units_deployed);
 
-            std::cout << "Player " << this->issuer->getName() << " has moved " << std::to_string(this->units_deployed) << " units to " << this->dest_terr->getName() << "!" << std::endl;
+            if (ostream *out = getOutput(this->issuer))
+                *out << "Player " << this->issuer->getName() << " has moved " << std::to_string(this->units_deployed) << " units to " << this->dest_terr->getName() << "!\n";
         }
         else
         {
+            Player *defender = this->issuer->getGame()->getOwner(this->dest_terr->getId());
             int attackers = this->units_deployed;
-            int defenders = this->dest_terr->getOwner() == nullptr ? 2 : this->dest_terr->getOwner()->getTerritoryUnits(this->dest_terr);
+            int defenders = defender == nullptr ? 2 : defender->getTerritoryUnits(this->dest_terr);
             int original_defenders = defenders;
             bool attacker_won = false;
 
             while (attackers > 0 && defenders > 0)
             {
-                int seed = rand() % 10;
+                int seed = this->issuer->getGame()->randomInt(0, 9);
                 if (seed > 3)
                     defenders--;
                 if (seed < 7)
@@ -271,8 +289,8 @@ void Advance::execute()
             if (attackers > 0 || this->issuer->getStrategyType() == StratType::Cheater)
             {
                 attacker_won = true;
-                if (this->dest_terr->getOwner() != nullptr)
-                    this->dest_terr->getOwner()->removeTerritory(this->dest_terr);
+                if (defender != nullptr)
+                    defender->removeTerritory(this->dest_terr);
                 this->issuer->addTerritory(const_cast<Territory *>(this->dest_terr));
                 this->issuer->setTerritoryUnits(this->source_terr, source_units);
                 this->issuer->setTerritoryUnits(this->dest_terr, attackers);
@@ -281,14 +299,16 @@ void Advance::execute()
             {
                 attacker_won = false;
                 this->issuer->setTerritoryUnits(this->source_terr, source_units);
-                if (this->dest_terr->getOwner() != nullptr)
-                    this->dest_terr->getOwner()->setTerritoryUnits(this->dest_terr, defenders < 0 ? 0 : defenders);
+                if (defender != nullptr)
+                    defender->setTerritoryUnits(this->dest_terr, defenders < 0 ? 0 : defenders);
             }
 
-            std::cout << "Player " << this->issuer->getName() << " has " << (attacker_won ? "conquered " : "tried to attack ") << this->dest_terr->getName() << " (from " << this->source_terr->getName() << ") with " << this->units_deployed << " (" << attackers << " remaining) units, against " << original_defenders << " (" << defenders << " remaining) units!" << std::endl;
+            if (ostream *out = getOutput(this->issuer))
+                *out << "Player " << this->issuer->getName() << " has " << (attacker_won ? "conquered " : "tried to attack ") << this->dest_terr->getName() << " (from " << this->source_terr->getName() << ") with " << this->units_deployed << " (" << attackers << " remaining) units, against " << original_defenders << " (" << defenders << " remaining) units!\n";
         }
     }
-    Notify(this);
+    if (isLogged(this->issuer))
+        Notify(this);
 }
 
 std::string Advance::stringToLog() const { return name; }
@@ -350,7 +370,8 @@ bool Airlift::validate()
 {
     if (this->issuer->owns(this->source_terr) && this->issuer->owns(this->source_terr) && this->issuer->owns(this->dest_terr) && this->units_deployed <= this->issuer->getTerritoryUnits(this->source_terr) && this->issuer->card_count(CardType::airlift) > 0)
         return true;
-    cout << this->name << " order invalid.";
+    if (ostream *out = getOutput(this->issuer))
+        *out << this->name << " order invalid.";
     return false;
 }
 
@@ -363,7 +384,8 @@ void Airlift::execute()
         int dest_sum = this->issuer->getTerritoryUnits(this->dest_terr) + this->units_deployed;
         this->issuer->setTerritoryUnits(this->dest_terr, dest_sum);
         this->issuer->getHand()->play(CardType::airlift);
-        Notify(this);
+        if (isLogged(this->issuer))
+            Notify(this);
     }
 }
 
@@ -425,7 +447,8 @@ bool Bomb::validate()
     if (this->target_player->owns(this->dest_terr) && this->issuer->card_count(CardType::bomb) > 0 && !this->issuer->isAllied(this->target_player))
         return true;
 
-    cout << this->name << " order invalid." << std::endl;
+    if (ostream *out = getOutput(this->issuer))
+        *out << this->name << " order invalid.\n";
     return false;
 }
 
@@ -436,8 +459,10 @@ void Bomb::execute()
         this->target_player->setTerritoryUnits(this->dest_terr, this->target_player->getTerritoryUnits(this->dest_terr) / 2);
         this->issuer->getHand()->play(CardType::bomb);
 
-        std::cout << "Player " << this->issuer->getName() << " has bombed " << this->dest_terr->getName() << " (" << this->target_player->getTerritoryUnits(this->dest_terr) << " units remaining)!" << std::endl;
-        Notify(this);
+        if (ostream *out = getOutput(this->issuer))
+            *out << "Player " << this->issuer->getName() << " has bombed " << this->dest_terr->getName() << " (" << this->target_player->getTerritoryUnits(this->dest_terr) << " units remaining)!\n";
+        if (isLogged(this->issuer))
+            Notify(this);
     }
 }
 
@@ -501,7 +526,8 @@ bool Blockade::validate()
 
     if (this->neutral_player->isNeutral() && this->issuer->card_count(CardType::blockade) > 0 && this->issuer->owns(this->dest_terr))
         return true;
-    cout << this->name << " order invalid.";
+    if (ostream *out = getOutput(this->issuer))
+        *out << this->name << " order invalid.";
     return false;
 }
 
@@ -514,7 +540,8 @@ void Blockade::execute()
         this->neutral_player->addTerritory(const_cast<Territory *>(this->dest_terr));
         this->neutral_player->setTerritoryUnits(this->dest_terr, units);
         this->issuer->getHand()->play(CardType::blockade);
-        Notify(this);
+        if (isLogged(this->issuer))
+            Notify(this);
     }
 }
 
@@ -577,7 +604,8 @@ bool Deploy::validate()
 {
     if (this->issuer->owns(this->dest_terr))
         return true;
-    cout << this->name << " order invalid.";
+    if (ostream *out = getOutput(this->issuer))
+        *out << this->name << " order invalid.";
     return false;
 }
 
@@ -591,9 +619,11 @@ void Deploy::execute()
             this->issuer->getHand()->play(CardType::reinforcement);
         }
 
-        std::cout << "Player " << this->issuer->getName() << " has deployed " << this->units_deployed << " additional units to " << this->dest_terr->getName() << " (" << this->issuer->getTerritoryUnits(this->dest_terr) << " total units)!" << std::endl;
+        if (ostream *out = getOutput(this->issuer))
+            *out << "Player " << this->issuer->getName() << " has deployed " << this->units_deployed << " additional units to " << this->dest_terr->getName() << " (" << this->issuer->getTerritoryUnits(this->dest_terr) << " total units)!\n";
 
-        Notify(this);
+        if (isLogged(this->issuer))
+            Notify(this);
     }
 }
 
@@ -650,7 +680,8 @@ bool Negotiate::validate()
 {
     if (this->issuer->card_count(CardType::diplomacy) > 0)
         return true;
-    cout << this->name << " order invalid.";
+    if (ostream *out = getOutput(this->issuer))
+        *out << this->name << " order invalid.";
     return false;
 }
 
@@ -661,7 +692,8 @@ void Negotiate::execute()
         this->issuer->addAlly(this->target_player);
         this->target_player->addAlly(this->issuer);
         this->issuer->getHand()->play(CardType::diplomacy);
-        Notify(this);
+        if (isLogged(this->issuer))
+            Notify(this);
     }
 }
 
@@ -14,10 +14,10 @@ void testOrdersList()
 {
      // Test: load map
      const shared_ptr<Map> gameMap = MapLoader::loadMap("maps/world.map");
-     SharedTerritoriesVector territories = Map::getAllTerritories(*gameMap);
+     TerritoriesVector territories = Map::getAllTerritories(*gameMap);
 
      // create two normal players and one neutral player with a set of territories and cards already
-     vector<Player> players;
+     vector<Player *> players;
      Player *p1 = new Player(1, "p1");
      Player *p2 = new Player(2, "p2");
      Player *neutral = new Player(true);
@@ -26,8 +26,12 @@ void testOrdersList()
      players.push_back(p2);
      players.push_back(neutral);
 
+     GameState game(gameMap);
+     for (auto &&player : players)
+          player->joinGame(&game);
+
      for (int i = 0; i < territories.size(); i++)
-          players[i % players.size()].addTerritory(&*territories[i]);
+          players[i % players.size()]->addTerritory(&*territories[i]);
 
      // Test validation of every order
      // Deploy
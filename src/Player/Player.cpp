@@ -11,11 +11,11 @@
 
 using namespace std;
 
-Player::Player() : playerId(0), name("player"), order_list(new OrdersList()) {}
+Player::Player() : playerId(0), name("player"), order_list(new OrdersList()), game(nullptr), slot(GameState::NO_OWNER) {}
 
 Player::Player(int playerID, string name) // Default is neutral player strategy.
     : playerId(playerID), name(name), order_list(new OrdersList()),
-      hand(new Hand()), m_strategy(ps::make_player_strat(StratType::Neutral))
+      hand(new Hand()), game(nullptr), slot(GameState::NO_OWNER), m_strategy(ps::make_player_strat(StratType::Neutral))
 {
 }
 
@@ -25,20 +25,19 @@ Player::Player(int playerID, string name) // Default is neutral player strategy.
 Player::Player(int playerID, string name, vector<Territory *> &territories,
                Hand *hand, OrdersList *orders, const StratType &strat)
     : playerId(playerID), name(name), territories(territories), hand(hand),
-      order_list(orders), m_strategy(ps::make_player_strat(strat)) {}
+      order_list(orders), game(nullptr), slot(GameState::NO_OWNER), m_strategy(ps::make_player_strat(strat)) {}
 
 Player::Player(bool isNeutral) : Player() { this->is_neutral = true; }
 
 // Creates a copy of the player object.
 Player::Player(const Player &p)
     : playerId(p.playerId), name(p.name), hand(new Hand(*(p.hand))),
-      order_list(new OrdersList(*(p.order_list))),
-      m_strategy(p.m_strategy->clone())
+      order_list(new OrdersList(*(p.order_list))), game(p.game),
+      slot(p.slot), m_strategy(p.m_strategy->clone())
 {
-  for (Territory *t : p.territories)
-  {
-    this->addTerritory(new Territory(*t));
-  }
+  // the copy sees the same territories, but their ownership stays with the
+  // original in the game state
+  territories = p.territories;
 }
 
 // Destructor.
@@ -61,10 +60,9 @@ Player &Player::operator=(const Player &p)
 
   playerId = p.playerId;
   name = p.name;
-  for (Territory *t : p.territories)
-  {
-    this->addTerritory(new Territory(*t));
-  }
+  game = p.game;
+  slot = p.slot;
+  territories = p.territories;
   this->hand = new Hand(*(p.hand));
   this->order_list = new OrdersList(*(p.order_list));
   m_strategy = p.m_strategy->clone();
@@ -83,10 +81,9 @@ Player &Player::operator=(Player &&p)
     // Move the data.
     playerId = std::move(p.playerId);
     name = std::move(p.name);
-    for (Territory *t : p.territories)
-    {
-      this->addTerritory(new Territory(*t));
-    }
+    game = p.game;
+    slot = p.slot;
+    territories = std::move(p.territories);
     // Move constructor here as well.
     hand = new Hand(std::move(*p.hand));
     // Move constructor not implemented here.
@@ -119,8 +116,8 @@ void Player::issueOrder(const Map &gameMap, std::vector<Player *> players)
 
 void Player::addTerritory(Territory *t)
 {
-  t->setOwner(this);
-  units_map[t->getName()] = 0;
+  game->setOwner(t->getId(), slot);
+  game->setUnits(t->getId(), 0);
   territories.push_back(t);
 }
 
@@ -128,7 +125,7 @@ void Player::removeTerritory(const Territory *t)
 {
   for (int i = 0; i < territories.size(); i++)
   {
-    if (territories[i]->getName() == t->getName())
+    if (territories[i]->getId() == t->getId())
     {
         territories.erase(territories.begin() + i);
         if(this->getStrategyType() == StratType::Neutral) {
@@ -137,7 +134,8 @@ void Player::removeTerritory(const Territory *t)
         break;
     }
   }
-  units_map.erase(t->getName());
+  if (game->getOwnerSlot(t->getId()) == slot)
+    game->setOwner(t->getId(), GameState::NO_OWNER);
 }
 
 void Player::addAlly(const Player *p)
@@ -161,11 +159,6 @@ bool Player::isAllied(Player *p)
   return false;
 }
 
-bool Player::owns(const Territory *t) const
-{
-  return t->getOwner() == this;
-}
-
 // getters
 int Player::getPlayerId() { return playerId; }
 
@@ -173,6 +166,10 @@ string Player::getName() { return name; }
 
 StratType Player::getStrategyType() const { return m_strategy->type(); }
 
+GameState *Player::getGame() const { return game; }
+
+GameState::PlayerSlot Player::getSlot() const { return slot; }
+
 int Player::card_count(const CardType &type) const noexcept
 {
   size_t count = 0;
@@ -192,17 +189,17 @@ OrdersList *Player ::getPlayerOrderList() { return order_list; }
 
 vector<Territory *> Player::getTerritories() { return territories; }
 
-int Player::getTerritoryUnits(const Territory *t) const
-{
-  std::string str = t->getName();
-  return units_map.at(str);
-}
-
 bool Player::conqueredThisTurn() { return conquered_this_turn; }
 
 bool Player::isNeutral() { return this->is_neutral; }
 
 // setters
+void Player::joinGame(GameState *game)
+{
+  this->game = game;
+  this->slot = game != nullptr ? game->addPlayer(this) : GameState::NO_OWNER;
+}
+
 void Player::setPlayerOrderList(OrdersList *orders)
 {
   this->order_list = orders;
@@ -222,11 +219,6 @@ ostream &operator<<(ostream &os, Player &p)
             << ", Strategy: " << p.getStrategyType() << "}";
 }
 
-void Player::setTerritoryUnits(const Territory *t, int units)
-{
-  units_map[t->getName()] = units;
-}
-
 void Player::setConqueredThisTurn(bool b) { this->conquered_this_turn = b; }
 
 void Player::setStrategy(const PlayerStrategy *strat)
@@ -239,7 +231,8 @@ void Player::resetNewGame() {
     this->order_list->remove(0);
   }
     this->hand->clear();
-    this->units_map.clear();
+    this->game = nullptr;
+    this->slot = GameState::NO_OWNER;
     this->territories.clear();
     this->allies.clear();
     this->conquered_this_turn = false;
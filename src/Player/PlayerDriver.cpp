@@ -1,5 +1,10 @@
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
 #include "Cards.h"
 #include "Map.h"
+#include "MapGenerator.h"
 #include "Orders.h"
 
 #include "Player.h"
@@ -13,6 +18,9 @@ void testPlayers()
   Player *p2 = new Player(2, "hashem");
   const auto map = MapLoader::loadMap("maps/world.map");
   const auto territories = Map::getAllTerritories(*map);
+  GameState game(map);
+  p1->joinGame(&game);
+  p2->joinGame(&game);
 
   // for (auto &&territory : territories)
   // {
@@ -49,7 +57,7 @@ void testPlayers()
   //========================ORDER LIST+++++++++++
   // doesn't work yet
   //  cout << "Player's orders list:" << endl;
-  Advance test_order = Advance(p1, map.get(), territories[0].get(), territories[1].get(), 5);
+  Advance test_order = Advance(p1, map.get(), territories[0], territories[1], 5);
 
   p1->issueOrder(*map, {p2});
 
@@ -76,4 +84,118 @@ void testPlayers()
   delete p1;
   delete p2;
   p1 = p2 = NULL;
-}
\ No newline at end of file
+}
+
+void benchmarkPlayers()
+{
+  cout << "TERRITORY UNITS LOOKUP BENCHMARK" << endl;
+
+  for (auto &&territoryCount : {0, 10000})
+  {
+    // 0 stands for maps/world.map
+    const shared_ptr<Map> map = territoryCount == 0 ? MapLoader::loadMap("maps/world.map") : MapGenerator::generate({MapFamily::RANDOM_GEOMETRIC, static_cast<size_t>(territoryCount), static_cast<size_t>(territoryCount / 100), 42});
+    const auto territories = Map::getAllTerritories(*map);
+
+    Player p1(1, "p1"), p2(2, "p2");
+    GameState game(map);
+    p1.joinGame(&game);
+    p2.joinGame(&game);
+
+    // what every lookup used to cost: a map keyed by territory name, hit through a copy of the name
+    std::unordered_map<string, int> unitsByName;
+
+    for (size_t i = 0; i < territories.size(); i++)
+    {
+      (i % 2 == 0 ? p1 : p2).addTerritory(territories[i]);
+      (i % 2 == 0 ? p1 : p2).setTerritoryUnits(territories[i], static_cast<int>(i % 7));
+      unitsByName[string(territories[i]->getName())] = static_cast<int>(i % 7);
+    }
+
+    const int rounds = 20000000 / static_cast<int>(territories.size());
+    long long byNameTotal = 0, arrayTotal = 0, owned = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++)
+    {
+      for (auto &&territory : territories)
+        byNameTotal += unitsByName.at(string(territory->getName()));
+    }
+    const auto byName = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < rounds; round++)
+    {
+      for (auto &&territory : territories)
+      {
+        arrayTotal += p1.owns(territory) ? p1.getTerritoryUnits(territory) : p2.getTerritoryUnits(territory);
+        owned += p1.owns(territory);
+      }
+    }
+    const auto byArray = std::chrono::steady_clock::now();
+
+    const double lookups = static_cast<double>(rounds) * territories.size();
+    cout << territories.size() << " territories: by name " << std::chrono::duration<double, std::nano>(byName - start).count() / lookups
+         << " ns per lookup, owns + getTerritoryUnits " << std::chrono::duration<double, std::nano>(byArray - byName).count() / lookups
+         << " ns per lookup (totals " << byNameTotal << " / " << arrayTotal << ", " << owned / rounds << " owned by p1)" << endl;
+
+    p1.resetNewGame();
+    p2.resetNewGame();
+  }
+
+  cout << "\nREINFORCEMENT COUNT BENCHMARK" << endl;
+
+  for (auto &&territoryCount : {42, 10000, 100000})
+  {
+    const shared_ptr<Map> map = MapGenerator::generate({MapFamily::CONTINENT_RING, static_cast<size_t>(territoryCount), std::max<size_t>(6, territoryCount / 100), 42});
+    const auto territories = Map::getAllTerritories(*map);
+
+    // four players, one of them holding the first continent entirely
+    std::vector<Player *> players;
+    GameState game(map);
+    for (int i = 0; i < 4; i++)
+    {
+      players.push_back(new Player(i, "p" + std::to_string(i)));
+      players.back()->joinGame(&game);
+    }
+
+    for (auto &&territory : territories)
+      players[Map::getContinentId(*map, territory->getId()) == 0 ? 0 : territory->getId() % 4]->addTerritory(territory);
+
+    const int rounds = 1000;
+    long long recounted = 0, counted = 0;
+
+    // what reinforcement used to do every turn: count each player's territories per continent, then compare with the continent sizes
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++)
+    {
+      for (auto &&player : players)
+      {
+        std::vector<size_t> owned(map->getContinentCount(), 0);
+        for (auto &&territory : player->getTerritories())
+          owned[Map::getContinentId(*map, territory->getId())]++;
+
+        recounted += player->getTerritories().size() / 3;
+        for (ContinentId continent = 0; continent < map->getContinentCount(); continent++)
+          recounted += owned[continent] == Map::getTerritoryIdsInContinent(*map, continent).size() ? Map::getContinent(*map, continent)->getBonus() : 0;
+      }
+    }
+    const auto recount = std::chrono::steady_clock::now();
+
+    // the incremental counters
+    for (int round = 0; round < rounds; round++)
+    {
+      for (auto &&player : players)
+      {
+        counted += game.getTerritoryCount(player->getSlot()) / 3;
+        game.forEachOwnedContinent(player->getSlot(), [&](ContinentId continent)
+                                   { counted += Map::getContinent(*map, continent)->getBonus(); });
+      }
+    }
+    const auto count = std::chrono::steady_clock::now();
+
+    cout << territories.size() << " territories, " << map->getContinentCount() << " continents: recounting " << std::chrono::duration<double, std::micro>(recount - start).count() / rounds
+         << " us per turn, counters " << std::chrono::duration<double, std::micro>(count - recount).count() / rounds << " us per turn (" << recounted / rounds << " / " << counted / rounds << " reinforcements)" << endl;
+
+    for (auto &&player : players)
+      delete player;
+  }
+}
@@ -70,16 +70,13 @@ namespace ps
 
     int no_reinforcements = get_no_reinf();
 
-    std::random_device rd;  // Generates a seed.
-    std::mt19937 rng(rd()); // Random seed
-    std::uniform_int_distribution<> random_idx(0, t_defend.size() - 1);
+    // Random numbers come from the game, so a seeded game replays the same.
+    GameState &game = *player->getGame();
     // Repeatedly randomly add soldiers to territories.
     while (no_reinforcements > 0)
     {
-      std::uniform_int_distribution<> random_no_soldiers(1, no_reinforcements);
-
-      const int idx = random_idx(rng);
-      const int no_soldiers = random_no_soldiers(rng);
+      const int idx = game.randomInt(0, t_defend.size() - 1);
+      const int no_soldiers = game.randomInt(1, no_reinforcements);
 
       Deploy *order = new Deploy(player, &gameMap, t_defend[idx], no_soldiers);
       player->getPlayerOrderList()->add(order);
@@ -104,7 +101,7 @@ namespace ps
     return strongest_t;
   }
 
-  Territory *find_strongest_territory_from_territories(const Map &map, Player *player, std::vector<Territory *> territories)
+  Territory *find_strongest_territory_from_territories(const Map &map, Player *player, const std::vector<Territory *> &territories)
   {
     Territory *strongest_t = nullptr;
     int no_units = -1;
@@ -112,10 +109,9 @@ namespace ps
     {
       // count if any enemy adjacent territories.
       bool has_enemy_adjacent = false;
-      for (const std::shared_ptr<Territory> &n :
-           Map::getAdjacentTerritories(map, t->getName()))
+      for (Territory *n : Map::getNeighbours(map, *t))
       {
-        if (!player->owns(n.get()))
+        if (!player->owns(n))
         {
           has_enemy_adjacent = true;
           break;
@@ -175,15 +171,14 @@ namespace ps
     // For each adjacent and not owned by the player.
     for (Territory *t : player->getTerritories())
     {
-      for (std::shared_ptr<Territory> n :
-           Map::getAdjacentTerritories(gameMap, t->getName()))
+      for (Territory *n : Map::getNeighbours(gameMap, *t))
       {
-        if (!player->owns(n.get()) &&
+        if (!player->owns(n) &&
             territories_to_attack.end() ==
                 std::find(territories_to_attack.begin(),
-                          territories_to_attack.end(), n.get()))
+                          territories_to_attack.end(), n))
         {
-          territories_to_attack.push_back(n.get());
+          territories_to_attack.push_back(n);
           break;
         }
       }
@@ -198,15 +193,14 @@ namespace ps
     std::vector<Territory *> territories_to_attack;
 
     // For each adjacent and not owned by the player.
-    for (std::shared_ptr<Territory> n :
-         Map::getAdjacentTerritories(gameMap, t->getName()))
+    for (Territory *n : Map::getNeighbours(gameMap, *t))
     {
-      if (!player->owns(n.get()) &&
+      if (!player->owns(n) &&
           territories_to_attack.end() ==
               std::find(territories_to_attack.begin(),
-                        territories_to_attack.end(), n.get()))
+                        territories_to_attack.end(), n))
       {
-        territories_to_attack.push_back(n.get());
+        territories_to_attack.push_back(n);
         break;
       }
     }
@@ -216,8 +210,8 @@ namespace ps
 
   void random_order(const Map &gameMap, Player *player, std::vector<Player *> players, std::vector<Territory *> toAttack, std::vector<Territory *> toDefend, const bool &make_harm)
   {
-    std::random_device rd;  // Generates a seed.
-    std::mt19937 rng(rd()); // Random seed
+    // Random numbers come from the game, so a seeded game replays the same.
+    GameState &game = *player->getGame();
 
     /*
         Calls each order depending on the value sampled from the uniform
@@ -233,28 +227,21 @@ namespace ps
     if (make_harm)
     {
       // Getting a random over the number of cards available.
-      std::uniform_int_distribution<int> airlift(0, get_count(CardType::airlift));
-      std::uniform_int_distribution<int> bomb(0, get_count(CardType::bomb));
-      std::uniform_int_distribution<int> blockade(0, get_count(CardType::blockade));
-
-      int no_airlift = airlift(rng);
-      int no_bomb = bomb(rng);
-      int no_blockade = blockade(rng);
+      int no_airlift = game.randomInt(0, get_count(CardType::airlift));
+      int no_bomb = game.randomInt(0, get_count(CardType::bomb));
+      int no_blockade = game.randomInt(0, get_count(CardType::blockade));
       for (int i = 0; i < no_airlift; i++)
       {
         if (toDefend.size() == 0)
           break;
 
-        std::uniform_int_distribution<int> random_idx(0, toDefend.size() - 1);
-        const int max_no_soldiers = player->getTerritoryUnits(toDefend[random_idx(rng)]);
+        const int max_no_soldiers = player->getTerritoryUnits(toDefend[game.randomInt(0, toDefend.size() - 1)]);
 
         if (max_no_soldiers == 0)
           continue;
 
-        std::uniform_int_distribution<int> random_no_soldiers(1, max_no_soldiers);
-
-        const int idx = random_idx(rng);
-        const int no_soldiers = random_no_soldiers(rng);
+        const int idx = game.randomInt(0, toDefend.size() - 1);
+        const int no_soldiers = game.randomInt(1, max_no_soldiers);
 
         const std::vector<Territory *> attackable_territories = enemy_adjacent_territories_from_territory(gameMap, player, toDefend[idx]);
 
@@ -269,9 +256,10 @@ namespace ps
         if (toAttack.size() == 0)
           break;
 
-        std::uniform_int_distribution<int> random_idx(0, toAttack.size() - 1);
+        // One draw for both the target and its owner (two draws in one call would be unsequenced).
+        Territory *target = toAttack[game.randomInt(0, toAttack.size() - 1)];
 
-        Bomb *bomb = new Bomb(player, &gameMap, toAttack[random_idx(rng)]->getOwner(), toAttack[random_idx(rng)]);
+        Bomb *bomb = new Bomb(player, &gameMap, game.getOwner(target->getId()), target);
         player->getPlayerOrderList()->add(bomb);
       }
       for (int i = 0; i < no_blockade; i++)
@@ -279,15 +267,12 @@ namespace ps
         if (toAttack.size() == 0)
           break;
 
-        std::uniform_int_distribution<int> random_idx(0, toAttack.size() - 1);
-
-        Blockade *blockade = new Blockade(player, &gameMap, nullptr, toAttack[random_idx(rng)]);
+        Blockade *blockade = new Blockade(player, &gameMap, nullptr, toAttack[game.randomInt(0, toAttack.size() - 1)]);
         player->getPlayerOrderList()->add(blockade);
       }
     }
 
-    std::uniform_int_distribution<> diplomacy(0, get_count(CardType::diplomacy));
-    int no_diplomacy = diplomacy(rng);
+    int no_diplomacy = game.randomInt(0, get_count(CardType::diplomacy));
     for (int i = 0; i < no_diplomacy; i++)
     {
       if (players.size() == 0)
@@ -506,7 +491,7 @@ void HumanPlayer::issue_order(
           continue;
         }
 
-        Bomb *order = new Bomb(player, &gameMap, target->getOwner(), target);
+        Bomb *order = new Bomb(player, &gameMap, player->getGame()->getOwner(target->getId()), target);
         player->getPlayerOrderList()->add(order);
         cards_count[CardType::bomb]--;
       }
@@ -605,15 +590,14 @@ std::vector<Territory *> HumanPlayer::to_attack(const Map &gameMap,
 
   for (Territory *t : player->getTerritories())
   {
-    for (std::shared_ptr<Territory> n :
-         Map::getAdjacentTerritories(gameMap, t->getName()))
+    for (Territory *n : Map::getNeighbours(gameMap, *t))
     {
-      if (!player->owns(n.get()) &&
+      if (!player->owns(n) &&
           territoriesToAttack.end() == std::find(territoriesToAttack.begin(),
                                                  territoriesToAttack.end(),
-                                                 n.get()))
+                                                 n))
       {
-        territoriesToAttack.push_back(n.get());
+        territoriesToAttack.push_back(n);
         break;
       }
     }
@@ -760,11 +744,11 @@ void CheaterPlayer::issue_order(
   {
     // get any owned adjacent territory and set it as source territory
     Territory *source = nullptr;
-    for (std::shared_ptr<Territory> n : Map::getAdjacentTerritories(gameMap, t->getName()))
+    for (Territory *n : Map::getNeighbours(gameMap, *t))
     {
-      if (player->owns(n.get()))
+      if (player->owns(n))
       {
-        source = n.get();
+        source = n;
         break;
       }
     }
@@ -17,25 +17,25 @@ void testPlayerStrategies()
         auto tempTerritories = Map::getAllTerritoriesInContinent(*map, *continents[0]);
         for (const auto &territory : tempTerritories)
         {
-            territoriesInFirstContinent.push_back(territory.get());
+            territoriesInFirstContinent.push_back(territory);
         }
 
         tempTerritories = Map::getAllTerritoriesInContinent(*map, *continents[1]);
         for (const auto &territory : tempTerritories)
         {
-            territoriesInSecondContinent.push_back(territory.get());
+            territoriesInSecondContinent.push_back(territory);
         }
 
         tempTerritories = Map::getAllTerritoriesInContinent(*map, *continents[2]);
         for (const auto &territory : tempTerritories)
         {
-            territoriesInThirdContinent.push_back(territory.get());
+            territoriesInThirdContinent.push_back(territory);
         }
 
         tempTerritories = Map::getAllTerritoriesInContinent(*map, *continents[3]);
         for (const auto &territory : tempTerritories)
         {
-            territoriesInFourthContinent.push_back(territory.get());
+            territoriesInFourthContinent.push_back(territory);
         }
     }
 
@@ -55,6 +55,12 @@ void testPlayerStrategies()
     p3->setStrategy(benevolent);
     p4->setStrategy(aggressive);
 
+    GameState game(map);
+    p1->joinGame(&game);
+    p2->joinGame(&game);
+    p3->joinGame(&game);
+    p4->joinGame(&game);
+
     p1->setTerritories(territoriesInFirstContinent);
     p2->setTerritories(territoriesInSecondContinent);
     p3->setTerritories(territoriesInThirdContinent);
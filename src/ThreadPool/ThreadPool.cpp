@@ -0,0 +1,50 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threadCount) : stopping(false)
+{
+    threadCount = std::max<size_t>(threadCount, 1);
+    workers.reserve(threadCount);
+
+    for (size_t i = 0; i < threadCount; i++)
+        workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    condition.notify_all();
+
+    for (auto &&worker : workers)
+        worker.join();
+}
+
+size_t ThreadPool::getThreadCount() const { return workers.size(); }
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]()
+                           { return stopping || !tasks.empty(); });
+
+            // queued tasks still run once stopping, so every future gets its result
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "WorkStealingScheduler.h"
+
+namespace
+{
+    // the jobs are only ever taken, never added, so a short lock per take is all the synchronisation needed
+    struct WorkerDeque
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+
+        bool popFront(size_t &job)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (jobs.empty())
+                return false;
+
+            job = jobs.front();
+            jobs.pop_front();
+            return true;
+        }
+
+        bool popBack(size_t &job)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (jobs.empty())
+                return false;
+
+            job = jobs.back();
+            jobs.pop_back();
+            return true;
+        }
+    };
+} // namespace
+
+double WorkStealingScheduler::Stats::getLongestJobSeconds() const
+{
+    return jobSeconds.empty() ? 0 : *std::max_element(jobSeconds.begin(), jobSeconds.end());
+}
+
+double WorkStealingScheduler::Stats::getUtilisation() const
+{
+    if (workers.empty() || wallSeconds <= 0)
+        return 0;
+
+    double busySeconds = 0;
+    for (auto &&worker : workers)
+        busySeconds += worker.busySeconds;
+
+    return std::min(1.0, busySeconds / (wallSeconds * workers.size()));
+}
+
+WorkStealingScheduler::Stats WorkStealingScheduler::run(size_t threadCount, const std::vector<size_t> &order, const std::function<void(size_t)> &job,
+                                                        const std::function<void(size_t, size_t)> &progress)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Stats stats;
+    threadCount = std::max<size_t>(1, std::min(threadCount, order.size()));
+    stats.jobSeconds.assign(order.size(), 0);
+    stats.workers.resize(threadCount);
+
+    std::vector<WorkerDeque> deques(threadCount);
+    for (size_t i = 0; i < order.size(); i++)
+        deques[i % threadCount].jobs.push_back(order[i]);
+
+    std::atomic<size_t> jobsDone{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    const auto work = [&](size_t worker)
+    {
+        auto &workerStats = stats.workers[worker];
+
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            size_t next;
+            bool found = deques[worker].popFront(next);
+
+            // steal, trying the workers after this one in turn
+            for (size_t offset = 1; !found && offset < threadCount; offset++)
+            {
+                found = deques[(worker + offset) % threadCount].popBack(next);
+                workerStats.steals += found;
+            }
+
+            // nothing is ever added, so every deque being empty means the batch is (being) finished
+            if (!found)
+                return;
+
+            const auto start = Clock::now();
+            try
+            {
+                job(next);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure)
+                    failure = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            stats.jobSeconds[next] = seconds;
+            workerStats.busySeconds += seconds;
+            workerStats.jobs++;
+
+            const auto done = jobsDone.fetch_add(1) + 1;
+            if (progress && !failed.load(std::memory_order_relaxed))
+                progress(next, done);
+        }
+    };
+
+    const auto start = Clock::now();
+    {
+        // the calling thread is the first worker
+        std::vector<std::thread> threads;
+        for (size_t worker = 1; worker < threadCount; worker++)
+            threads.emplace_back(work, worker);
+
+        work(0);
+
+        for (auto &&thread : threads)
+            thread.join();
+    }
+    stats.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (failure)
+        std::rethrow_exception(failure);
+
+    return stats;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/file.h>
+#include <thread>
+#include <unistd.h>
+
+#include "GameDurations.h"
+
+namespace
+{
+    constexpr const char *GAME_DURATIONS_VERSION = "RISKGAMEDURATIONS 1";
+
+    // the mean weighs the new game as 1 / min(games, window): a plain mean at first, then a moving one
+    constexpr uint64_t MEAN_WINDOW = 32;
+
+    std::string getFileName(const std::string &mapPath)
+    {
+        return std::filesystem::path(mapPath).filename().string();
+    }
+} // namespace
+
+GameDurations::GameDurations(const std::string &directory) : directory(directory)
+{
+    load(getPath(directory), durations);
+}
+
+void GameDurations::load(const std::string &path, std::unordered_map<std::string, Duration> &durations)
+{
+    std::ifstream file(path);
+    std::string line;
+
+    if (!std::getline(file, line) || line != GAME_DURATIONS_VERSION)
+        return;
+
+    // one tab-separated line per map: file name, mean seconds, games
+    while (std::getline(file, line))
+    {
+        const auto nameEnd = line.find('\t');
+        if (nameEnd == std::string::npos || nameEnd == 0)
+            continue;
+
+        std::istringstream fields(line.substr(nameEnd + 1));
+        Duration duration;
+
+        if (fields >> duration.meanSeconds >> duration.games && duration.meanSeconds >= 0)
+            durations[line.substr(0, nameEnd)] = duration;
+    }
+}
+
+void GameDurations::add(Duration &duration, double seconds)
+{
+    duration.games++;
+    duration.meanSeconds += (seconds - duration.meanSeconds) / std::min(duration.games, MEAN_WINDOW);
+}
+
+std::string GameDurations::getPath(const std::string &directory)
+{
+    return (std::filesystem::path(directory) / ".gamedurations").string();
+}
+
+double GameDurations::getExpectedSeconds(const std::string &mapPath) const
+{
+    const auto duration = durations.find(getFileName(mapPath));
+
+    return duration == durations.end() ? -1 : duration->second.meanSeconds;
+}
+
+void GameDurations::record(const std::string &mapPath, double seconds)
+{
+    add(durations[getFileName(mapPath)], seconds);
+    recorded.emplace_back(getFileName(mapPath), seconds);
+}
+
+bool GameDurations::save()
+{
+    const auto path = getPath(directory);
+
+    // one process saves at a time, each adding its own games to what the others saved since it loaded the file
+    const int lock = open((path + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+    if (lock < 0 || flock(lock, LOCK_EX) != 0)
+    {
+        if (lock >= 0)
+            close(lock);
+        return false;
+    }
+
+    std::unordered_map<std::string, Duration> current;
+    load(path, current);
+    for (auto &&[name, seconds] : recorded)
+        add(current[name], seconds);
+
+    // written next to the file and renamed over it, so a concurrent tournament reads either the old file or the new one
+    const auto temporaryPath = path + ".tmp" + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::ofstream file(temporaryPath, std::ios::trunc);
+    file << GAME_DURATIONS_VERSION << '\n';
+
+    for (auto &&[name, duration] : current)
+        file << name << '\t' << duration.meanSeconds << '\t' << duration.games << '\n';
+
+    file.close();
+
+    std::error_code error;
+    const bool saved = !file.fail() && (std::filesystem::rename(temporaryPath, path, error), !error);
+    if (saved)
+    {
+        durations = std::move(current);
+        recorded.clear();
+    }
+    else
+        std::filesystem::remove(temporaryPath, error);
+
+    close(lock); // releases the lock
+    return saved;
+}
@@ -1,4 +1,8 @@
 
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
 #include "GameEngine.h"
 void testTournament() {
     // create new game engine
@@ -9,4 +13,135 @@ void testTournament() {
 
     delete gameEngine;
     gameEngine = nullptr;
-}
\ No newline at end of file
+}
+
+// Throws away everything written to it.
+class DiscardBuffer : public std::streambuf {
+protected:
+    int_type overflow(int_type character) override { return traits_type::not_eof(character); }
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+void benchmarkTournament() {
+    std::cout << "TOURNAMENT SCALING BENCHMARK" << std::endl;
+
+    const std::vector<std::string> maps = {"world", "small"};
+    const std::vector<std::string> players = {"aggressive", "benevolent", "neutral"};
+    const int games = 5, turns = 50;
+
+    std::vector<size_t> threadCounts = {1, 2, 4};
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads > threadCounts.back())
+        threadCounts.push_back(hardwareThreads);
+
+    double sequentialSeconds = 0;
+    for (size_t threads : threadCounts) {
+        GameEngine engine;
+
+        // the games' output is only formatted, not printed
+        DiscardBuffer discard;
+        auto *console = std::cout.rdbuf(&discard);
+        const auto start = std::chrono::steady_clock::now();
+        engine.startTournament(maps, players, games, turns, 42, threads);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout.rdbuf(console);
+
+        if (threads == 1)
+            sequentialSeconds = seconds;
+
+        const auto &stats = engine.lastTournamentStats;
+        size_t steals = 0;
+        for (auto &&worker : stats.workers)
+            steals += worker.steals;
+
+        std::cout << maps.size() << " maps x " << games << " games x " << turns << " turns on " << threads << " threads ("
+                  << hardwareThreads << " hardware): " << seconds * 1000 << " ms, speedup " << sequentialSeconds / seconds
+                  << ", longest game " << stats.getLongestJobSeconds() * 1000 << " ms, utilisation " << stats.getUtilisation() * 100
+                  << "%, " << steals << " steals" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+void benchmarkOutputSinks() {
+    std::cout << "OUTPUT SINK BENCHMARK" << std::endl;
+
+    const auto map = MapLoader::loadMap("maps/world.map");
+    const std::vector<std::string> players = {"aggressive", "benevolent", "neutral"};
+    const int games = 20, turns = 50;
+
+    // the same games (same seeds) with each sink, one after another on this thread, without the game log so only the sinks differ
+    NullSink null;
+    BufferedSink buffered;
+    ConsoleSink console;
+    const std::pair<const char *, OutputSink *> sinks[] = {{"null", &null}, {"buffered", &buffered}, {"console", &console}};
+
+    for (auto &&[name, sink] : sinks) {
+        // the console sink prints for real, into a buffer that throws everything away
+        DiscardBuffer discard;
+        auto *consoleBuffer = std::cout.rdbuf(&discard);
+
+        size_t bytes = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int game = 0; game < games; game++) {
+            GameEngine::playTournamentGame(map, players, game, turns, GameState::getGameSeed(42, 0, game), *sink,
+                                           StalemateRules(), false);
+            bytes += buffered.take().size();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout.rdbuf(consoleBuffer);
+
+        std::cout << name << " sink: " << games << " games x " << turns << " turns in " << seconds * 1000 << " ms, "
+                  << games / seconds << " games/s";
+        if (sink == &buffered)
+            std::cout << " (" << bytes / games << " bytes of messages per game)";
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+void testShardedTournament() {
+    std::cout << "SHARDED TOURNAMENT TEST" << std::endl;
+
+    const std::vector<std::string> maps = {"world", "small"};
+    const std::vector<std::string> players = {"aggressive", "benevolent", "neutral"};
+    const int games = 3, turns = 20, shards = 3;
+    const uint64_t seed = 7;
+    const std::string directory = (std::filesystem::temp_directory_path() / "risk-tournament-shards").string();
+    std::filesystem::remove_all(directory);
+
+    // the games' own output is left out, only the tables are shown
+    DiscardBuffer discard;
+    auto *console = std::cout.rdbuf(&discard);
+
+    GameEngine single;
+    single.startTournament(maps, players, games, turns, seed);
+
+    GameEngine sharded;
+    const size_t missing = sharded.startShardedTournament(maps, players, games, turns, seed, shards, directory);
+    std::cout.rdbuf(console);
+
+    std::cout << "Single process:\n" << single.tournament_log << std::endl;
+    std::cout << shards << " processes (" << missing << " shards missing), same table: "
+              << (sharded.tournament_log == single.tournament_log ? "yes" : "no") << std::endl;
+
+    // a lost shard: its games show as Missing, until it's played again on its own
+    std::filesystem::remove(std::filesystem::path(directory) / "shard-2-of-3.txt");
+    GameEngine merged;
+    std::cout.rdbuf(&discard);
+    const size_t missingAfterLoss = merged.mergeTournamentShards(maps, players, games, turns, seed, shards, directory);
+    std::cout.rdbuf(console);
+    std::cout << "\nWithout shard 2 (" << missingAfterLoss << " shards missing):\n" << merged.tournament_log << std::endl;
+
+    std::cout.rdbuf(&discard);
+    GameEngine rerun;
+    const bool replayed = rerun.runTournamentShard(maps, players, games, turns, seed, 1, shards, directory);
+    const size_t missingAfterRerun = merged.mergeTournamentShards(maps, players, games, turns, seed, shards, directory);
+    std::cout.rdbuf(console);
+    std::cout << "Shard 2 played again: " << (replayed ? "yes" : "no") << " (" << missingAfterRerun << " shards missing), same table: "
+              << (merged.tournament_log == single.tournament_log ? "yes" : "no") << std::endl;
+
+    std::filesystem::remove_all(directory);
+    std::cout << std::endl;
+}
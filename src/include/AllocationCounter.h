@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+    Counts the heap allocations made by the program (through the global operator new) from the moment it's created.
+    Used by the benchmarks to report allocation counts and bytes, e.g. per loaded territory or per neighbour query.
+
+    Counting replaces the global operator new and delete, so it's only built in with the RISK_COUNT_ALLOCATIONS CMake
+    option (off by default); without it, ENABLED is false and every count is 0.
+*/
+#ifndef RISK_COUNT_ALLOCATIONS
+class AllocationCounter
+{
+public:
+    static constexpr bool ENABLED = false;
+
+    AllocationCounter() {}
+
+    size_t getAllocations() const { return 0; }
+    size_t getAllocatedBytes() const { return 0; }
+    long long getLiveBytes() const { return 0; }
+};
+#else
+class AllocationCounter
+{
+private:
+    size_t startAllocations;
+    size_t startAllocatedBytes;
+    size_t startLiveBytes;
+
+public:
+    static constexpr bool ENABLED = true;
+
+    AllocationCounter();
+
+    // number of allocations since the counter was created
+    size_t getAllocations() const;
+
+    // bytes requested by those allocations (whether or not they were freed since)
+    size_t getAllocatedBytes() const;
+
+    // change in the bytes currently allocated (allocated minus freed) since the counter was created
+    long long getLiveBytes() const;
+};
+#endif
@@ -132,7 +132,10 @@ public:
 
   /*
     Inserts a specified number of random cards inside the card's container.
+    The cards are drawn from the given engine (a game's), or from an engine of
+    the calling thread seeded once from the hardware.
   */
+  void random_insert(const int &, std::mt19937_64 &) noexcept;
   void random_insert(const int &) noexcept;
 
   /*
@@ -193,7 +196,9 @@ public:
   /*
     Draw a card at random from the cards remaining in the deck.
     Place it in the their hand of cards.
+    Same engines as Buffer::random_insert.
    */
+  void draw(Hand &, std::mt19937_64 &);
   void draw(Hand &);
 
   /*
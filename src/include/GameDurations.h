@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+    How long tournament games took on each map, kept across runs in a text file inside the maps' directory
+    (e.g. "maps/.gamedurations"). The tournament plays the maps' games longest-expected-first with it.
+
+    Each map keeps a running mean of its games' durations, over the last few dozen games at most, so it follows
+    changes in the players or the number of turns without being thrown off by a single unusual game.
+
+    Several processes (the shards of a tournament) can record and save at once: saving reads the file again under a
+    lock and adds this instance's games to it, so every process's games are kept.
+*/
+class GameDurations
+{
+private:
+    struct Duration
+    {
+        double meanSeconds = 0;
+        uint64_t games = 0;
+    };
+
+    std::string directory;
+    std::unordered_map<std::string, Duration> durations;    // by map file name
+    std::vector<std::pair<std::string, double>> recorded; // games recorded since loading: map file name, seconds
+
+    static void load(const std::string &path, std::unordered_map<std::string, Duration> &durations);
+    static void add(Duration &duration, double seconds);
+
+public:
+    // loads the durations kept in the directory, if any
+    explicit GameDurations(const std::string &directory);
+
+    /// @return the expected duration of a game on the map, or a negative value if it was never played
+    double getExpectedSeconds(const std::string &mapPath) const;
+
+    void record(const std::string &mapPath, double seconds);
+
+    /// @brief Adds the games recorded since loading (or the last save) to the directory's file (atomically, like the map catalog's index)
+    bool save();
+
+    // path of a directory's durations file (e.g. "maps" -> "maps/.gamedurations")
+    static std::string getPath(const std::string &directory);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -9,8 +10,13 @@
 #include "Cards.h"
 #include "Map.h"
 #include "Command.h"
+#include "GameState.h"
 #include "LoggingObserver.h"
+#include "OutputSink.h"
 #include "Player.h"
+#include "Stalemate.h"
+#include "TournamentConfig.h"
+#include "WorkStealingScheduler.h"
 
 using std::ostream;
 using std::shared_ptr;
@@ -21,6 +27,9 @@ void testGameStates();
 void testMainGameLoop();
 void testStartupPhase();
 void testTournament();
+void benchmarkTournament();
+void benchmarkOutputSinks();
+void testShardedTournament();
 
 // class State; // Forward declaration
 class CommandProcessor;
@@ -29,11 +38,24 @@ class Map;
 class GameEngine : private ILoggable, private Subject
 {
   shared_ptr<State> currState;
+  OutputSink *output = &OutputSink::console(); // where the phases' messages go
   void initGame();
   void reinforcementPhase(vector<Player *> players, const Map &map);
   void issueOrdersPhase(vector<Player *> players, const Map &map);
   void executeOrdersPhase(vector<Player *> players);
-  void startTournament(vector<std::string> mapList, vector<std::string> playerList, int numGames, int numTurns);
+  // loads and validates a tournament's maps and players (throws on an unknown player type); false if a map is invalid
+  static bool loadTournament(const vector<std::string> &mapList, const vector<std::string> &playerList, vector<shared_ptr<Map>> &maps,
+                             vector<std::string> &mapPaths, std::string &mapsLine, std::string &playersLine);
+  // plays some games of a tournament (by index: map index * numGames + game index) on a work-stealing scheduler,
+  // handing each game's result and output to `onGameFinished` in the order of `games` (no output when `quiet`, no game log unless `gameLog`)
+  static WorkStealingScheduler::Stats playTournamentGames(const vector<shared_ptr<Map>> &maps, const vector<std::string> &mapPaths, const vector<std::string> &playerList,
+                                                          int numGames, int numTurns, uint64_t seed, const vector<size_t> &games, size_t threadCount, bool longestFirst,
+                                                          bool quiet, bool gameLog, const StalemateRules &stalemate, const std::function<void(size_t, const std::string &, const std::string &)> &onGameFinished);
+  // the tournament log's lines above the table (maps, players, games, turns, seed and the stalemate rules if any)
+  static std::string formatTournamentHeader(const std::string &mapsLine, const std::string &playersLine, int numGames, int numTurns, uint64_t seed,
+                                            const StalemateRules &stalemate);
+  // the tournament log: the header, then the results table of the first `mapCount` maps
+  static std::string formatTournamentLog(const std::string &header, const vector<std::string> &images, const vector<std::string> &results, int numGames, size_t mapCount);
 
 public:
   bool isTournament;
@@ -47,6 +69,7 @@ public:
   vector<Player *> players;
   std::string stringToLog() const override;
   std::shared_ptr<Map> map;
+  std::shared_ptr<GameState> game; // state of the game started by startupPhase
   Deck *deck;
 
   CommandProcessor *commandProcessor;
@@ -58,7 +81,37 @@ public:
   GameEngine &operator=(const GameEngine &other);
   friend ostream &operator<<(ostream &os, const GameEngine &gameEngine);
 
-  void initiateTournament();
+  bool quiet = false;      // tournament games discard their messages, without formatting them
+  bool gameLog = true;      // state changes (and, in tournament games, orders) are written to the game log
+  StalemateRules stalemate; // when mainGameLoop ends a stalled game early (off by default)
+
+  // plays one game of a tournament with its own engine, players and state, its messages going to `output` (and its orders
+  // and state changes to the game log if `gameLog`); returns its result for the table
+  static std::string playTournamentGame(const shared_ptr<Map> &map, const vector<std::string> &playerList, int gameIndex, int numTurns, uint64_t seed,
+                                        OutputSink &output, const StalemateRules &stalemate = StalemateRules(), bool gameLog = true);
+
+  // asks the tournament's settings on the console, within `limits`
+  void initiateTournament(const TournamentLimits &limits = TournamentLimits());
+  // runs a tournament from its config (see TournamentConfig), writing the results table to its output path if it has one;
+  // returns the process exit status: 0 when every game was played, 1 when the tournament is invalid, 2 when shards are missing
+  int runTournament(const TournamentConfig &config);
+  // plays the games on `threadCount` threads (0: one per hardware thread), each game seeded from `seed` and its place;
+  // `longestFirst` starts the games of the maps whose past games took longest first
+  void startTournament(vector<std::string> mapList, vector<std::string> playerList, int numGames, int numTurns, uint64_t seed, size_t threadCount = 0, bool longestFirst = true);
+  WorkStealingScheduler::Stats lastTournamentStats; // how the last tournament's games were spread over the threads
+
+  // forks `processCount` processes, one per shard (see runTournamentShard), each on `threadsPerProcess` threads (0: the
+  // hardware threads split between them), waits for them and merges their results; returns the number of shards missing
+  // from the merge (crashed or failed)
+  size_t startShardedTournament(vector<std::string> mapList, vector<std::string> playerList, int numGames, int numTurns, uint64_t seed,
+                                size_t processCount, const std::string &resultsDirectory, size_t threadsPerProcess = 0);
+  // plays shard `shard` (from 0) of `shardCount`: every shardCount-th game of the tournament, written to
+  // `resultsDirectory`/shard-<shard + 1>-of-<shardCount>.txt (the games' output to the matching .log)
+  bool runTournamentShard(vector<std::string> mapList, vector<std::string> playerList, int numGames, int numTurns, uint64_t seed,
+                          size_t shard, size_t shardCount, const std::string &resultsDirectory, size_t threadCount = 0);
+  // rebuilds tournament_log from the shard files of this tournament; returns the number of shards missing or from another tournament
+  size_t mergeTournamentShards(vector<std::string> mapList, vector<std::string> playerList, int numGames, int numTurns, uint64_t seed,
+                               size_t shardCount, const std::string &resultsDirectory);
   string mainGameLoop(vector<Player *> players, const Map &gameMap, int numTurns = -1);
 };
 std::string formatForTable(std::string input);
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Map.h"
+#include "OutputSink.h"
+
+class Player;
+
+/*
+    Mutable state of a single game: who owns each territory and how many units are on it, indexed by territory ID.
+    The map itself is shared read-only, so any number of games (one after another or at the same time) can be played
+    on one loaded map without copying it; a new game starts from a new GameState, with every territory unowned.
+
+    The state is laid out as parallel arrays (one byte of owner and one int of units per territory), so scanning a
+    player's territories touches a few cache lines instead of chasing pointers, and every lookup is an array load.
+
+    Ownership changes also keep per-player counters up to date: territories owned in total and in each continent, and
+    a bit-set of the continents a player owns entirely. Reinforcement reads them instead of recounting the map.
+
+    Every random draw of the game (turn order, cards, battle rolls, random orders) comes from the game's own engine,
+    seeded once when the game starts: a game replays identically from its seed, whichever games run beside it. Numbers
+    are taken straight from the engine (not through std:: distributions), so a seed gives the same game with every
+    standard library.
+
+    The game's messages go to its output sink (the console unless told otherwise), so games played side by side each
+    keep their own. Whether its orders are written to the game log (gamelog.txt) is a separate setting.
+*/
+class GameState
+{
+public:
+    // index of a player in the game, in join order
+    using PlayerSlot = uint8_t;
+    static constexpr PlayerSlot NO_OWNER = UINT8_MAX;
+    static constexpr size_t MAX_PLAYERS = NO_OWNER;
+
+    using Rng = std::mt19937_64;
+
+private:
+    std::shared_ptr<const Map> map;
+    std::vector<Player *> players; // by slot
+    std::vector<PlayerSlot> owners;
+    std::vector<int32_t> units;
+
+    // per player (by slot): territories owned, territories owned in each continent (continentCount counters per player),
+    // and continents owned entirely (continentWords bit-set words per player, bit c set when continent c is)
+    std::vector<uint32_t> continentSizes;
+    size_t continentWords;
+    std::vector<uint32_t> territoryCounts;
+    std::vector<uint32_t> continentCounts;
+    std::vector<uint64_t> ownedContinents;
+
+    uint64_t seed;
+    Rng rng;
+
+    OutputSink *output = &OutputSink::console();
+    bool logged = true;
+
+public:
+    /// @param seed seeds the game's random numbers; the same seed (and the same players' choices) replays the same game
+    explicit GameState(std::shared_ptr<const Map> map, uint64_t seed = Rng::default_seed);
+
+    /// @brief Seed of one game of a tournament, mixed from the tournament's seed and the game's place in it
+    /// @details Doesn't depend on the order the games are played in, so games can run in any order (or concurrently)
+    static uint64_t getGameSeed(uint64_t tournamentSeed, size_t mapIndex, size_t gameIndex);
+
+    const Map &getMap() const;
+    const std::shared_ptr<const Map> &getSharedMap() const;
+
+    /// @brief Registers a player in the game (Player::joinGame does it)
+    /// @return the player's slot, or NO_OWNER if the game already has MAX_PLAYERS players
+    PlayerSlot addPlayer(Player *player);
+
+    /// @return the territory's owner, or nullptr if nobody owns it
+    Player *getOwner(TerritoryId territory) const { return owners[territory] == NO_OWNER ? nullptr : players[owners[territory]]; }
+    PlayerSlot getOwnerSlot(TerritoryId territory) const { return owners[territory]; }
+
+    /// @brief Gives a territory to a player (or to nobody, with NO_OWNER), updating both players' counters in O(1)
+    void setOwner(TerritoryId territory, PlayerSlot owner);
+
+    /// @brief Number of territories a player owns, in O(1)
+    size_t getTerritoryCount(PlayerSlot player) const { return territoryCounts[player]; }
+
+    /// @brief Number of territories a player owns in a continent, in O(1)
+    size_t getTerritoryCount(PlayerSlot player, ContinentId continent) const { return continentCounts[player * continentSizes.size() + continent]; }
+
+    /// @brief Checks if a player owns every territory of a continent, in O(1)
+    bool ownsContinent(PlayerSlot player, ContinentId continent) const { return ownedContinents[player * continentWords + continent / 64] >> (continent % 64) & 1; }
+
+    /// @brief Calls `function` with the ID of every continent a player owns entirely, in ID order
+    /// @details Walks the player's bit-set a word at a time, so the cost is in the number of continents / 64 plus the ones owned
+    template <typename Function>
+    void forEachOwnedContinent(PlayerSlot player, Function &&function) const
+    {
+        for (size_t word = 0; word < continentWords; word++)
+        {
+            for (auto bits = ownedContinents[player * continentWords + word]; bits != 0; bits &= bits - 1)
+                function(static_cast<ContinentId>(word * 64 + __builtin_ctzll(bits)));
+        }
+    }
+
+    int getUnits(TerritoryId territory) const { return units[territory]; }
+    void setUnits(TerritoryId territory, int units) { this->units[territory] = units; }
+
+    OutputSink &getOutput() const { return *output; }
+    void setOutput(OutputSink &output) { this->output = &output; }
+
+    /// @brief Whether the game's orders are written to the game log (they are by default), whatever its output sink
+    bool isLogged() const { return logged; }
+    void setLogged(bool logged) { this->logged = logged; }
+
+    /// @brief Hash of every territory's owner: it changes when (and, but for collisions, only when) a territory changes hands
+    uint64_t getOwnershipHash() const;
+
+    /// @brief Hash of every territory's owner and units: two equal boards hash the same, in O(territories)
+    uint64_t getStateHash() const;
+
+    uint64_t getSeed() const { return seed; }
+    Rng &getRng() { return rng; }
+
+    /// @return a random integer in [low, high] (low when the range is empty)
+    int randomInt(int low, int high) { return high <= low ? low : low + static_cast<int>(rng() % (static_cast<uint64_t>(high - low) + 1)); }
+
+    /// @brief Shuffles a range with the game's engine (Fisher-Yates)
+    template <typename Iterator>
+    void shuffle(Iterator first, Iterator last)
+    {
+        for (auto count = std::distance(first, last); count > 1; count--)
+            std::iter_swap(first + (count - 1), first + static_cast<decltype(count)>(rng() % count));
+    }
+};
@@ -4,28 +4,62 @@
 #define MAX_CONTINENTS 32
 #define MAX_TERRITORIES 255
 
+// maps up to this size cache a full hop-distance matrix, larger ones keep DISTANCE_CACHE_ROWS recently used BFS rows
+#define MAX_DISTANCE_MATRIX_TERRITORIES 2048
+#define DISTANCE_CACHE_ROWS 16
+
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <atomic>
 #include <vector>
 #include <array>
+#include <functional>
 #include <string>
-#include <regex>
+#include <string_view>
+#include <utility>
 #include <unordered_map>
 #include <unordered_set>
 #include <iostream>
+#include <iterator>
 
 void testLoadMaps();
+void benchmarkMaps();
 
 // forward declarations
-class Player;
+
+class ThreadPool;
 
 class Map;
 class Continent;
 class Territory;
 
 // complex type's declarations
-typedef std::unordered_map<std::string, std::vector<std::string>> AdjacencyMap;
-typedef std::vector<std::shared_ptr<Territory>> SharedTerritoriesVector;
-typedef std::vector<std::shared_ptr<Continent>> SharedContinentsVector;
+typedef uint32_t TerritoryId;
+typedef uint32_t ContinentId;
+typedef std::vector<Territory *> TerritoriesVector;
+typedef std::vector<const Continent *> ContinentsVector;
+
+constexpr TerritoryId INVALID_TERRITORY_ID = std::numeric_limits<TerritoryId>::max();
+constexpr ContinentId INVALID_CONTINENT_ID = std::numeric_limits<ContinentId>::max();
+constexpr uint32_t UNREACHABLE_DISTANCE = std::numeric_limits<uint32_t>::max();
+
+// non-owning view over a contiguous run of territory IDs (e.g. the neighbours of a territory)
+struct TerritoryIdRange
+{
+    const TerritoryId *first;
+    const TerritoryId *last;
+
+    const TerritoryId *begin() const { return first; }
+    const TerritoryId *end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+};
+
+// one row of the adjacency bit-matrix of maps with at most MAX_TERRITORIES territories:
+// bit (j % 64) of word (j / 64) is set when territory j is a neighbour (255 rows of 256 bits, about 8 KB)
+typedef std::array<uint64_t, (MAX_TERRITORIES + 64) / 64> AdjacencyRow;
 
 enum class MapSection
 {
@@ -53,71 +87,220 @@ enum class ScrollDirection
 
 std::ostream &operator<<(std::ostream &os, const ScrollDirection &direction);
 
-// remove leading & trailing whitespace (https://stackoverflow.com/a/1798170)
-static std::string trim(const std::string &str, const std::string &whitespace = " \t\r\n");
-
-static ScrollDirection getScrollDirectionFromString(const std::string &scrollDirectionString);
-static bool getBooleanFromString(const std::string &booleanString);
-static std::string getStringFromBoolean(const bool &boolean);
-
 class Continent
 {
+    friend class Map;
     friend class MapLoader;
 
 private:
-    uint16_t *bonus;
-    std::string *name;
-    size_t *territoryCount;
+    ContinentId id;
+    uint16_t bonus;
+    size_t territoryCount;
+    std::string_view name; // interned by the map that owns the continent
 
 public:
     Continent();
-    Continent(const Continent &continent);
-    ~Continent();
 
-    Continent &operator=(const Continent &continent);
     friend std::ostream &operator<<(std::ostream &os, const Continent &continent);
 
-    std::string getName() const;
+    ContinentId getId() const;
+    std::string_view getName() const;
     uint16_t getBonus() const;
     size_t getTerritoryCount() const;
 };
 
 class Territory
 {
+    friend class Map;
     friend class MapLoader;
 
 private:
-    std::shared_ptr<Continent> continent;
-
-    uint16_t *x, *y;
-    std::string *name;
-    Player *owner;
+    TerritoryId id;
+    uint16_t x, y;
+    std::string_view name; // interned by the map that owns the territory
+    const Continent *continent;
 
 public:
     Territory();
-    Territory(const Territory &territory);
-    ~Territory();
 
-    Territory &operator=(const Territory &territory);
     friend std::ostream &operator<<(std::ostream &os, const Territory &territory);
 
-    std::string getName() const;
+    TerritoryId getId() const;
+    std::string_view getName() const;
     uint16_t getX() const;
     uint16_t getY() const;
-    const std::shared_ptr<Continent> &getContinent() const;
+    const Continent *getContinent() const;
+};
+
+// non-owning view over the territories of a run of IDs (e.g. a territory's neighbours): iterating it yields pointers
+// straight into the map's territory array, without allocating or copying anything
+class TerritoryRange
+{
+private:
+    TerritoryIdRange ids;
+    Territory *territories;
 
-    Player *getOwner() const;
-    void setOwner(Player *owner);
+public:
+    class iterator
+    {
+    private:
+        const TerritoryId *id;
+        Territory *territories;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Territory *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Territory *const *;
+        using reference = Territory *;
+
+        iterator(const TerritoryId *id, Territory *territories) : id(id), territories(territories) {}
+
+        Territory *operator*() const { return territories + *id; }
+        iterator &operator++()
+        {
+            ++id;
+            return *this;
+        }
+        iterator operator++(int) { return iterator(id++, territories); }
+        bool operator==(const iterator &other) const { return id == other.id; }
+        bool operator!=(const iterator &other) const { return id != other.id; }
+    };
+
+    TerritoryRange(TerritoryIdRange ids, Territory *territories) : ids(ids), territories(territories) {}
+
+    iterator begin() const { return iterator(ids.begin(), territories); }
+    iterator end() const { return iterator(ids.end(), territories); }
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+    Territory *operator[](size_t index) const { return territories + ids.first[index]; }
+
+    const TerritoryIdRange &getIds() const { return ids; }
 };
 
 class Map
 {
     friend class MapLoader;
+    friend class MapGenerator;
 
 private:
-    AdjacencyMap adjacency;
-    std::unordered_map<std::string, std::shared_ptr<Territory>> territories;
-    std::unordered_map<std::string, std::shared_ptr<Continent>> continents;
+    // interned names: every name is copied once into blocks that never move (so the views into them stay valid), shared by copies of the map
+    struct NameArena
+    {
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t used = 0;
+        size_t capacity = 0;
+
+        std::string_view intern(std::string_view name);
+    };
+
+    std::shared_ptr<NameArena> names;
+
+    // name lookups, keyed by the interned names
+    std::unordered_map<std::string_view, TerritoryId> territoryIds;
+    std::unordered_map<std::string_view, ContinentId> continentIds;
+
+    // territories and continents are stored by value, indexed by the IDs handed out while loading (in file order);
+    // the arrays never grow once the map is built, so pointers into them are stable handles for the map's lifetime
+    // (a map never changes once built, per-game state lives in GameState; the territories are still handed out as
+    // non-const pointers since that is what the game code stores)
+    mutable std::vector<Territory> territoriesById;
+    std::vector<Continent> continentsById;
+
+    // compressed-sparse-row adjacency: the neighbours of territory i are adjacencyTargets[adjacencyOffsets[i], adjacencyOffsets[i + 1])
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<TerritoryId> adjacencyTargets;
+
+    // continent membership index: territory i is in continentOfTerritory[i], and the members of continent c are
+    // continentMembers[continentMemberOffsets[c], continentMemberOffsets[c + 1]) in ID order
+    std::vector<ContinentId> continentOfTerritory;
+    std::vector<uint32_t> continentMemberOffsets;
+    std::vector<TerritoryId> continentMembers;
+
+    // packed adjacency bit-matrix (one AdjacencyRow per territory), empty when the map has more than MAX_TERRITORIES territories
+    std::vector<AdjacencyRow> adjacencyMatrix;
+
+    // graph topology, precomputed once the adjacency is in place (see MapTopology.cpp):
+    // per-territory TOPOLOGY_* flags, the articulation points in ID order, the bridges as (lower ID, higher ID) pairs in sorted order,
+    // and per continent its border territories (members with a neighbour outside it) and entry points (outsiders with a neighbour in it),
+    // laid out like the membership index
+    std::vector<uint8_t> topologyFlags;
+    std::vector<TerritoryId> articulationPoints;
+    std::vector<std::pair<TerritoryId, TerritoryId>> bridges;
+    std::vector<uint32_t> borderOffsets;
+    std::vector<TerritoryId> borderTerritories;
+    std::vector<uint32_t> entryPointOffsets;
+    std::vector<TerritoryId> entryPoints;
+
+    static constexpr uint8_t TOPOLOGY_ARTICULATION_POINT = 1;
+    static constexpr uint8_t TOPOLOGY_BORDER = 2;
+
+    // uniform grid over the territory coordinates (see MapSpatialIndex.cpp), about two territories per cell: the territories of
+    // cell (column, row) are cellTerritories[cellOffsets[row * columns + column], cellOffsets[row * columns + column + 1]);
+    // an unwrapped axis spans the bounding box of the coordinates, a wrapped one a whole period starting at 0
+    struct SpatialIndex
+    {
+        int32_t originX = 0, originY = 0;
+        int32_t width = 1, height = 1;
+        bool wrapX = false, wrapY = false;
+        uint32_t columns = 1, rows = 1;
+        std::vector<uint32_t> cellOffsets = std::vector<uint32_t>(2, 0);
+        std::vector<TerritoryId> cellTerritories;
+    };
+
+    SpatialIndex spatialIndex;
+
+    // hop distances and next hops, filled lazily by the first queries (see MapDistances.cpp)
+    struct DistanceCache
+    {
+        std::mutex mutex;
+
+        // full matrices (row-major, one row per source) for maps of at most MAX_DISTANCE_MATRIX_TERRITORIES territories
+        std::atomic<bool> matrixBuilt{false};
+        std::vector<uint16_t> matrixDistances;
+        std::vector<uint16_t> matrixNextHops;
+
+        // least recently used BFS rows for larger maps, reusing their buffers when evicted
+        struct Row
+        {
+            TerritoryId source = INVALID_TERRITORY_ID;
+            uint64_t lastUse = 0;
+            std::vector<uint32_t> distances;
+            std::vector<TerritoryId> nextHops;
+        };
+
+        std::vector<Row> rows;
+        uint64_t clock = 0;
+        std::vector<TerritoryId> queue;
+    };
+
+    std::unique_ptr<DistanceCache> distances;
+
+    // computes the distance matrices on the first call, returns false if the map is too large for them
+    static bool ensureDistanceMatrix(const Map &map);
+
+    // the cached BFS row of a source, computed into the least recently used row on a miss (the cache must be locked)
+    static DistanceCache::Row &getDistanceRow(const Map &map, TerritoryId source);
+
+    // construction helpers for MapLoader and MapGenerator, IDs are handed out densely in call order
+    // both return the INVALID_*_ID constant if the name is already taken (or the continent doesn't exist)
+    ContinentId addContinent(std::string_view name, uint16_t bonus);
+    TerritoryId addTerritory(std::string_view name, uint16_t x, uint16_t y, ContinentId continent);
+
+    // (re)builds the continent members, the topology, the spatial grid and the adjacency bit-matrix, once every territory and the CSR adjacency are in place
+    void buildIndexes();
+
+    // (re)computes the articulation points, bridges, border territories and entry points (needs the continent index)
+    void buildTopology();
+
+    // (re)buckets the territories into the spatial grid, wrapping the axis given by the scroll direction if the map wraps
+    void buildSpatialIndex();
+
+    // (re)builds the adjacency bit-matrix from the CSR adjacency, left empty for maps of more than MAX_TERRITORIES territories
+    void buildAdjacencyMatrix();
+
+    // points every territory at its continent in this map's own array (after the array grew, or the map was copied)
+    void bindContinents();
 
     std::string *image;
     std::string *author;
@@ -134,29 +317,126 @@ public:
     Map &operator=(const Map &map);
     friend std::ostream &operator<<(std::ostream &os, const Map &map);
 
-    static SharedContinentsVector getAllContinents(const Map &map);
-    static SharedTerritoriesVector getAllTerritories(const Map &map);
-    static SharedTerritoriesVector getAllTerritoriesInContinent(const Map &map, const Continent &continent);
-    static SharedTerritoriesVector getAllTerritoriesInContinent(const Map &map, const std::string &continent);
+    static ContinentsVector getAllContinents(const Map &map);
+    static TerritoriesVector getAllTerritories(const Map &map);
+    static TerritoriesVector getAllTerritoriesInContinent(const Map &map, const Continent &continent);
+    static TerritoriesVector getAllTerritoriesInContinent(const Map &map, std::string_view continent);
+    static TerritoriesVector getAllTerritoriesInContinent(const Map &map, ContinentId continent);
 
     /// @brief Checks if the list of passed territories are all part of the same continent and if the continent has no other territories
     /// @return true if all territories are in the same continent and the continent has no other territories
-    static bool areAllTerritoriesInContinentExclusive(const Map &map, const std::string &continent, const std::vector<std::string> &territories);
+    static bool areAllTerritoriesInContinentExclusive(const Map &map, std::string_view continent, const std::vector<std::string> &territories);
+    static bool areAllTerritoriesInContinentExclusive(const Map &map, ContinentId continent, const std::vector<TerritoryId> &territories);
 
     /// @brief Checks if the list of passed territories are all part of the same continent
     /// @return true if all territories are in the same continent
-    static bool areAllTerritoriesInContinent(const Map &map, const std::string &continent, const std::vector<std::string> &territories);
+    static bool areAllTerritoriesInContinent(const Map &map, std::string_view continent, const std::vector<std::string> &territories);
+    static bool areAllTerritoriesInContinent(const Map &map, ContinentId continent, const std::vector<TerritoryId> &territories);
 
-    static SharedTerritoriesVector getAdjacentTerritories(const Map &map, const Territory &territory);
-    static SharedTerritoriesVector getAdjacentTerritories(const Map &map, const std::string &territory);
+    static TerritoriesVector getAdjacentTerritories(const Map &map, const Territory &territory);
+    static TerritoriesVector getAdjacentTerritories(const Map &map, std::string_view territory);
+    static TerritoriesVector getAdjacentTerritories(const Map &map, TerritoryId territory);
     static bool areAdjacent(const Map &map, const Territory &territory1, const Territory &territory2);
-    static bool areAdjacent(const Map &map, const std::string &territory1, const std::string &territory2);
+    static bool areAdjacent(const Map &map, std::string_view territory1, std::string_view territory2);
+
+    /// @brief Checks if two territories are neighbours, a single bit test on maps with an adjacency bit-matrix
+    static bool areAdjacent(const Map &map, TerritoryId territory1, TerritoryId territory2);
+
+    /// @brief Checks if the map is small enough (at most MAX_TERRITORIES territories) to carry an adjacency bit-matrix
+    static bool hasAdjacencyMatrix(const Map &map);
+
+    /// @brief Returns a territory's neighbours as a row of the adjacency bit-matrix, for word-wide set operations
+    /// @return the row, or nullptr if the map has no bit-matrix (use getAdjacentTerritoryIds instead)
+    static const AdjacencyRow *getAdjacencyRow(const Map &map, TerritoryId territory);
+
+    /// @brief Counts the neighbours two territories share (word-wide AND + popcount on maps with a bit-matrix)
+    static size_t countCommonNeighbours(const Map &map, TerritoryId territory1, TerritoryId territory2);
+
+    /// @brief Looks up the dense ID of a territory by name
+    /// @return the territory's ID, or INVALID_TERRITORY_ID if the map has no such territory
+    static TerritoryId getTerritoryId(const Map &map, std::string_view territory);
+    static Territory *getTerritory(const Map &map, TerritoryId territory);
+    static const Continent *getContinent(const Map &map, ContinentId continent);
+
+    /// @brief Returns the IDs of a territory's neighbours, straight out of the CSR arrays (no allocation)
+    static TerritoryIdRange getAdjacentTerritoryIds(const Map &map, TerritoryId territory);
+
+    /// @brief Returns a territory's neighbours as a non-owning view (no allocation), valid as long as the map
+    static TerritoryRange getNeighbours(const Map &map, const Territory &territory);
+    static TerritoryRange getNeighbours(const Map &map, TerritoryId territory);
+
+    /// @brief Number of hops on the shortest path between two territories (BFS over the adjacency)
+    /// @details The first query on a map of at most MAX_DISTANCE_MATRIX_TERRITORIES territories computes every distance, later
+    /// ones are a table lookup; larger maps run one BFS per source and keep the last DISTANCE_CACHE_ROWS sources cached
+    /// @return the distance, or UNREACHABLE_DISTANCE if there is no path
+    static uint32_t distance(const Map &map, TerritoryId from, TerritoryId to);
+
+    /// @brief First territory to move to on a shortest path between two territories, cached like distance()
+    /// @return the neighbour of `from` to move to, or INVALID_TERRITORY_ID if `from` is `to` or there is no path
+    static TerritoryId nextHop(const Map &map, TerritoryId from, TerritoryId to);
+
+    /// @brief Looks up the dense ID of a continent by name
+    /// @return the continent's ID, or INVALID_CONTINENT_ID if the map has no such continent
+    static ContinentId getContinentId(const Map &map, std::string_view continent);
+
+    /// @brief Returns the ID of the continent a territory belongs to, in O(1)
+    static ContinentId getContinentId(const Map &map, TerritoryId territory);
+
+    /// @brief Returns the IDs of a continent's territories in ID order, straight out of the membership index (no allocation)
+    static TerritoryIdRange getTerritoryIdsInContinent(const Map &map, ContinentId continent);
+
+    /// @brief Returns a continent's territories in ID order as a non-owning view (no allocation), valid as long as the map
+    static TerritoryRange getTerritoriesInContinent(const Map &map, ContinentId continent);
 
-    static void countTraversedTerritories(const Map &map, const std::string &territory, std::unordered_set<std::string> *visited);
-    static void countTraversedTerritoriesInContinent(const Map &map, const std::string &continent, const std::string &territory, std::unordered_set<std::string> *visited);
+    /// @brief Checks if removing a territory would split the map (or its part of the map) in two, in O(1)
+    /// @details Articulation points are the map's chokepoints: whoever holds one cuts every path through it
+    static bool isArticulationPoint(const Map &map, TerritoryId territory);
 
+    /// @brief Returns the IDs of the map's articulation points in ID order (no allocation)
+    static TerritoryIdRange getArticulationPoints(const Map &map);
+
+    /// @brief Returns the map's bridges, the edges whose removal would split the map, as (lower ID, higher ID) pairs in sorted order
+    static const std::vector<std::pair<TerritoryId, TerritoryId>> &getBridges(const Map &map);
+
+    /// @brief Checks if the edge between two territories is a bridge (binary search over the bridges)
+    static bool isBridge(const Map &map, TerritoryId territory1, TerritoryId territory2);
+
+    /// @brief Checks if a territory has a neighbour in another continent, in O(1)
+    static bool isBorderTerritory(const Map &map, TerritoryId territory);
+
+    /// @brief Returns the IDs of a continent's border territories (its members with a neighbour outside it) in ID order (no allocation)
+    static TerritoryIdRange getBorderTerritoryIds(const Map &map, ContinentId continent);
+
+    /// @brief Returns a continent's border territories as a non-owning view (no allocation), valid as long as the map
+    static TerritoryRange getBorderTerritories(const Map &map, ContinentId continent);
+
+    /// @brief Returns the IDs of a continent's entry points (territories outside it with a neighbour in it, i.e. where attacks on it come from) in ID order (no allocation)
+    static TerritoryIdRange getEntryPointIds(const Map &map, ContinentId continent);
+
+    /// @brief Returns a continent's entry points as a non-owning view (no allocation), valid as long as the map
+    static TerritoryRange getEntryPoints(const Map &map, ContinentId continent);
+
+    /// @brief Lists the territories whose coordinates lie in the rectangle [left, right] x [top, bottom] (bounds included), in ID order
+    /// @details Only the grid cells overlapping the rectangle are scanned. On a map that wraps (wrap=yes with a horizontal or vertical
+    /// scroll), the rectangle wraps around that axis too, e.g. a rectangle past the right edge continues on the left one
+    static void getTerritoryIdsInRect(const Map &map, int32_t left, int32_t top, int32_t right, int32_t bottom, std::vector<TerritoryId> &territories);
+
+    /// @brief Lists the (at most) k territories closest to a point, nearest first (ties broken by ID)
+    /// @details Distances are Euclidean, measured around the wrapped axis on maps that wrap; the grid is searched ring by ring
+    /// outwards from the point's cell, stopping once no unvisited cell can hold anything closer
+    /// @param accept optional filter (e.g. "owned by an enemy"), rejected territories are skipped
+    static void getNearestTerritoryIds(const Map &map, int32_t x, int32_t y, size_t k, std::vector<TerritoryId> &territories, const std::function<bool(TerritoryId)> &accept = nullptr);
+
+    /// @brief Returns the territory closest to a point among the accepted ones
+    /// @return its ID, or INVALID_TERRITORY_ID if no territory is accepted
+    static TerritoryId getNearestTerritoryId(const Map &map, int32_t x, int32_t y, const std::function<bool(TerritoryId)> &accept = nullptr);
+
+    /// @brief Checks that the map is a connected graph, that its continents are connected subgraphs and that each territory belongs to exactly one continent
+    /// @details Runs in O(territories + edges) with an explicit stack and bit-vectors, so it handles maps of any size or shape (e.g. long chains)
     static void validate(Map *map);
 
+    size_t getTerritoryCount() const;
+    size_t getContinentCount() const;
     std::string getImage() const;
     std::string getAuthor() const;
     bool getWrap() const;
@@ -165,20 +445,86 @@ public:
     bool getWarn() const;
 };
 
+// what MapLoader::loadMapHeader reads of a map file: its [Map] fields and the size of its other sections
+struct MapHeader
+{
+    std::string author;
+    std::string image;
+    bool wrap = false;
+    ScrollDirection scroll = ScrollDirection::NONE;
+    bool warn = false;
+    size_t continentCount = 0; // lines in [Continents]
+    size_t territoryCount = 0; // lines in [Territories]
+};
+
 class MapLoader
 {
 private:
-    inline static const std::regex HEADER_PATTERN = std::regex("\\[(.+)\\]", std::regex_constants::icase);        // captures the section name (e.g. "[Map]", without the brackets)
-    inline static const std::regex FIELD_PATTERN = std::regex("(^.+)=(.+)", std::regex_constants::icase);         // captures the field name (e.g. "name=", without the equals sign)
-    inline static const std::regex COMMA_SEPARATED_PATTERN = std::regex("([^,]+)+", std::regex_constants::icase); // basically splits the string by commas
+    // state kept while parsing a single file; every view points into the file buffer, so nothing is allocated per field
+    struct ParseState
+    {
+        // neighbour names laid out like the CSR adjacency: the names of territory i are adjacencyNames[adjacencyNameOffsets[i], adjacencyNameOffsets[i + 1])
+        std::vector<uint32_t> adjacencyNameOffsets = std::vector<uint32_t>(1, 0);
+        std::vector<std::string_view> adjacencyNames;
+    };
 
 public:
-    static std::shared_ptr<Map> loadMap(const std::string &path);
+    /// @brief Parses a .map file (without validating it)
+    /// @details `hash`, if given, gets the hashMapFile hash of exactly the bytes that were parsed (0 if the file can't be read)
+    static std::shared_ptr<Map> loadMap(const std::string &path, uint64_t *hash = nullptr);
+
+    /// @brief Reads only the [Map] section of a file, and counts the lines of its [Continents] and [Territories] sections
+    /// @details Nothing is resolved or validated, so the counts are those of a valid map only if the file is one. The file
+    /// is mapped and read once: `hash`, if given, gets its hashMapFile hash from the same pass
+    /// @return false if the file can't be opened
+    static bool loadMapHeader(const std::string &path, MapHeader &header, uint64_t *hash = nullptr);
+
+    /// @brief Loads a map through its compiled (.mapbin) cache, parsing, validating and recompiling the source when the cache is missing or stale
+    /// @return the map, already validated
+    static std::shared_ptr<Map> loadMapCached(const std::string &path);
+
+    /// @brief Loads a list of maps through loadMapCached concurrently on a thread pool
+    /// @return the maps in the order of `paths`; once a map turns out invalid, every later map that hasn't started loading
+    /// is skipped (left as nullptr), so the first invalid map is the first non-valid entry
+    static std::vector<std::shared_ptr<Map>> loadMapsCached(const std::vector<std::string> &paths, ThreadPool &pool);
+
+    /// @brief Maps a compiled map file into memory and copies the map out of it, its indexes included, without parsing,
+    /// validating or recomputing anything; only the name lookup tables are rebuilt
+    /// @return the map, or nullptr if the file is missing, corrupt, of another version, or wasn't compiled from a source with this hash
+    static std::shared_ptr<Map> loadCompiledMap(const std::string &path, uint64_t sourceHash);
+
+    /// @brief Writes a validated map in the compiled (.mapbin) format, tagged with the hash of its source file
+    /// @return true if the file was written, false if the map isn't valid or the file couldn't be written
+    static bool writeCompiledMap(const Map &map, const std::string &path, uint64_t sourceHash);
+
+    // content hash of a source map file (0 if the file can't be read)
+    static uint64_t hashMapFile(const std::string &path);
+
+    // path of the compiled cache of a source map file (e.g. "maps/world.map" -> "maps/world.mapbin")
+    static std::string getCompiledMapPath(const std::string &path);
 
 private:
-    static uint8_t getMapSection(const std::string &line);
+    static int8_t getMapSection(std::string_view line);
 
-    static bool processMapLine(const std::string &line, const std::shared_ptr<Map> &map);
-    static bool processContinentsLine(const std::string &line, const std::shared_ptr<Map> &map);
-    static bool processTerritoriesLine(const std::string &line, const std::shared_ptr<Map> &map);
+    // 64-bit FNV-1a, continued from `hash`, so a file can be hashed a piece at a time
+    static uint64_t hashBytes(const char *bytes, size_t size, uint64_t hash = 14695981039346656037ull);
+
+    // loadMapHeader's parse of a file's contents, hashing them as it goes (if `hash` isn't nullptr)
+    static void parseMapHeader(std::string_view contents, MapHeader &header, uint64_t *hash);
+
+    static bool processMapLine(std::string_view line, const std::shared_ptr<Map> &map);
+    static bool processContinentsLine(std::string_view line, const std::shared_ptr<Map> &map);
+    static bool processTerritoriesLine(std::string_view line, const std::shared_ptr<Map> &map, ParseState &state);
+
+    // resolves the neighbour names collected while parsing into the map's CSR adjacency arrays
+    static void buildAdjacency(const std::shared_ptr<Map> &map, const ParseState &state);
+};
+
+class MapWriter
+{
+public:
+    /// @brief Serialises a map back to the Conquest .map format read by MapLoader
+    /// @return true if the whole file was written
+    static bool writeMap(const Map &map, const std::string &path);
+    static void writeMap(const Map &map, std::ostream &os);
 };
\ No newline at end of file
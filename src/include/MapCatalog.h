@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Map.h"
+
+struct MapCatalogEntry
+{
+    std::string path;
+    MapHeader header;
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0; // the file's last write time, in ticks of the filesystem clock
+    uint64_t hash = 0;        // content hash, the one MapLoader::hashMapFile computes (and compiled maps are tagged with)
+};
+
+/*
+    Catalog of the maps in a directory, for listing and filtering them without loading any.
+    A scan keeps its results in an index file inside the directory, so the next scan only reads the files that are new
+    or whose size or modification time changed since; the others come straight out of the index.
+*/
+class MapCatalog
+{
+public:
+    /// @brief Lists the .map files of a directory, sorted by path, with the metadata of each
+    /// @param rescannedFiles if given, set to the number of files that had to be read (the others came from the index)
+    /// @return the entries, empty if the directory doesn't exist
+    static std::vector<MapCatalogEntry> scanDirectory(const std::string &directory, size_t *rescannedFiles = nullptr);
+
+    /// @brief Reads the metadata of a single map file: its header and section sizes (see MapLoader::loadMapHeader) and its hash
+    /// @return false if the file can't be read
+    static bool scanMapFile(const std::string &path, MapCatalogEntry &entry);
+
+    // path of a directory's index file (e.g. "maps" -> "maps/.mapcatalog")
+    static std::string getIndexPath(const std::string &directory);
+
+private:
+    // the index is a text file: a version line, then one tab-separated line per map (file name first)
+    static std::vector<MapCatalogEntry> readIndex(const std::string &directory);
+    static bool writeIndex(const std::string &directory, const std::vector<MapCatalogEntry> &entries);
+};
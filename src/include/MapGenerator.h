@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Map.h"
+
+enum class MapFamily
+{
+    GRID,
+    CONTINENT_RING,
+    RANDOM_GEOMETRIC,
+    SCALE_FREE
+};
+
+std::ostream &operator<<(std::ostream &os, const MapFamily &family);
+
+struct MapGeneratorOptions
+{
+    MapFamily family = MapFamily::GRID;
+    size_t territoryCount = 42;
+    size_t continentCount = 6;
+    uint64_t seed = 0;
+};
+
+class MapGenerator
+{
+private:
+    using EdgeList = std::vector<std::pair<TerritoryId, TerritoryId>>;
+
+public:
+    /// @brief Builds a synthetic map of the given family; the same options (seed included) always produce the same map
+    /// @details Territories are named "Territory <id>" and continents "Continent <id>", every continent is a connected subgraph
+    /// and the whole map is connected, so generated maps validate. The continent count is clamped to [1, territoryCount].
+    /// @return the generated map, already validated
+    static std::shared_ptr<Map> generate(const MapGeneratorOptions &options);
+
+    /// @brief Parses a family name ("grid", "ring", "geometric" or "scalefree")
+    /// @return true if the name is known
+    static bool getFamilyFromString(std::string_view familyString, MapFamily &family);
+
+private:
+    // each family assigns territories to continents (contiguous ID ranges, continent by continent), places them and lists their edges
+    // (the grid is the same for every seed, so it takes no random engine)
+    static void generateGrid(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges);
+    static void generateContinentRing(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges, std::mt19937_64 &rng);
+    static void generateRandomGeometric(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges, std::mt19937_64 &rng);
+    static void generateScaleFree(const MapGeneratorOptions &options, std::vector<ContinentId> &continentOf, std::vector<std::pair<uint16_t, uint16_t>> &positions, EdgeList &edges, std::mt19937_64 &rng);
+
+    // turns an edge list (in any order, possibly with duplicates) into the map's symmetric CSR adjacency
+    static void buildAdjacency(Map &map, EdgeList &edges);
+};
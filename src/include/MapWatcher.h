@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Map.h"
+
+/*
+    Hot reload of map files for long-running processes.
+
+    Each watched file has a current version, an immutable Map published through std::atomic_store. A background
+    thread waits on inotify for the files' directories, re-parses and re-validates a file once it has been written
+    (or replaced by a rename), and publishes the new version only if it is valid. Games take a snapshot with getMap
+    when they start and keep it to the end: a later version never touches a map a game already holds.
+*/
+class MapWatcher
+{
+private:
+    struct WatchedMap
+    {
+        std::string path;
+        std::shared_ptr<const Map> map; // only accessed through std::atomic_load / std::atomic_store
+        std::atomic<uint64_t> version{0};
+        uint64_t hash = 0; // content hash of the published version, so rewriting the same content publishes nothing
+    };
+
+    int inotifyFd = -1;
+    int wakeFds[2] = {-1, -1}; // pipe the destructor writes to, to wake the thread out of poll
+
+    // watched maps by path, and the paths of the watched files by inotify watch descriptor and file name
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<WatchedMap>> maps;
+    std::unordered_map<int, std::string> directories;
+
+    std::thread thread;
+
+    void work();
+
+    // re-parses a file and publishes it if it is valid and differs from the current version
+    void reload(WatchedMap &watched);
+
+public:
+    MapWatcher();
+    ~MapWatcher();
+
+    MapWatcher(const MapWatcher &) = delete;
+    MapWatcher &operator=(const MapWatcher &) = delete;
+
+    /// @brief Loads a map (through its compiled cache) and watches its file from now on
+    /// @return false if the map isn't valid (it is then neither published nor watched) or inotify is unavailable;
+    /// true without doing anything if the path is already watched
+    bool watch(const std::string &path);
+
+    /// @brief Returns the current version of a watched map, a snapshot that stays unchanged whatever happens to the file
+    /// @return the map, or nullptr if the path isn't watched
+    std::shared_ptr<const Map> getMap(const std::string &path) const;
+
+    /// @brief Number of times a watched map was published (1 after watch, then one more per valid change)
+    uint64_t getVersion(const std::string &path) const;
+};
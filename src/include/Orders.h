@@ -22,8 +22,8 @@ class Order
 public:
   std::string description;
   std::string name;
-  Player *issuer;
-  const Map *map;
+  Player *issuer = nullptr;
+  const Map *map = nullptr;
 
   Order() = delete;
   Order(const Order &other);
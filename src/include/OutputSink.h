@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/*
+    Where the messages of a game (phases, orders, eliminations, the winner) go.
+
+    The engine and the orders never print directly: they ask their sink for a stream and write to it. A sink that
+    discards messages has no stream (nullptr), and callers check for it before building a message, so a quiet game
+    formats nothing at all, instead of formatting every line to throw it away.
+
+    ConsoleSink prints to std::cout (the default, for games played interactively), BufferedSink keeps one game's
+    messages to be printed (or saved) when the game is over, and NullSink discards them.
+*/
+class OutputSink
+{
+public:
+    virtual ~OutputSink() = default;
+
+    /// @return the stream to write messages to, or nullptr if they're discarded (and shouldn't be formatted)
+    virtual std::ostream *getStream() = 0;
+
+    /// @brief Writes out what's been written so far, if the sink holds any of it back
+    virtual void flush() {}
+
+    /// @brief The console sink every engine and game uses until given another one
+    static OutputSink &console();
+};
+
+class NullSink : public OutputSink
+{
+public:
+    std::ostream *getStream() override { return nullptr; }
+};
+
+class ConsoleSink : public OutputSink
+{
+public:
+    std::ostream *getStream() override;
+    void flush() override;
+};
+
+class BufferedSink : public OutputSink
+{
+private:
+    std::ostringstream buffer;
+
+public:
+    std::ostream *getStream() override { return &buffer; }
+
+    /// @return the messages written since the last call, emptying the buffer
+    std::string take();
+};
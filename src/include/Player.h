@@ -7,12 +7,14 @@
 #include <vector>
 
 #include "Cards.h"
+#include "GameState.h"
 #include "Map.h"
 #include "Orders.h"
 
 using namespace std;
 
 void testPlayers();
+void benchmarkPlayers();
 
 enum class StratType : char;
 class PlayerStrategy;
@@ -30,7 +32,8 @@ private:
   vector<Territory *> territories; // List of owned territories
   std::vector<Player *> allies;    // list of allies for the turn
   OrdersList *order_list;
-  std::unordered_map<string, int> units_map;
+  GameState *game; // game the player is in (owners and units live there), nullptr between games
+  GameState::PlayerSlot slot; // the player's slot in that game
   int playerId;
   bool conquered_this_turn;
   bool is_neutral;
@@ -78,6 +81,8 @@ public:
   Hand *getHand();
   string getName();
   StratType getStrategyType() const;
+  GameState *getGame() const;
+  GameState::PlayerSlot getSlot() const;
   vector<Territory *> getTerritories();
   int getTerritoryUnits(const Territory *t) const;
   bool isNeutral();
@@ -106,6 +111,7 @@ public:
   bool isAllied(Player *p);
 
   // sets
+  void joinGame(GameState *game); // must be called before the player is given territories
   void setPlayerOrderList(OrdersList *orders);
   void setTerritories(vector<Territory *> t);
   void setTerritoryUnits(const Territory *t, int units);
@@ -117,4 +123,21 @@ public:
 /**
  * Stream insertion operator
  */
-ostream &operator<<(ostream &os, Player &p);
\ No newline at end of file
+ostream &operator<<(ostream &os, Player &p);
+
+// the lookups every strategy and order runs in its loops, inlined down to a
+// load from the game state's arrays
+inline int Player::getTerritoryUnits(const Territory *t) const
+{
+  return game->getUnits(t->getId());
+}
+
+inline void Player::setTerritoryUnits(const Territory *t, int units)
+{
+  game->setUnits(t->getId(), units);
+}
+
+inline bool Player::owns(const Territory *t) const
+{
+  return slot != GameState::NO_OWNER && game->getOwnerSlot(t->getId()) == slot;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "GameState.h"
+
+/*
+  When a game that has stopped going anywhere ends, instead of playing on to its last turn.
+
+  A game is stalled once no territory has changed hands for `window` turns in a row, or (with `repeatedState`)
+  once the board (every territory's owner and units) is back to what it was at the end of an earlier turn. Both are
+  off by default, so games only end with a winner or on their last turn.
+*/
+struct StalemateRules
+{
+  int window = 0;             // turns in a row without a territory changing hands that end the game (0: never)
+  bool repeatedState = false; // a board seen at the end of an earlier turn ends the game
+  std::string result = "Stalemate draw";
+
+  bool isEnabled() const { return window > 0 || repeatedState; }
+
+  // the rules for the tournament log, e.g. "no capture in 10 turns, repeated state"
+  std::string describe() const;
+};
+
+/*
+  Follows one game's board from turn to turn (through the game state's hashes) and tells when it's stalled.
+*/
+class StalemateDetector
+{
+private:
+  const StalemateRules &rules;
+  uint64_t ownership;
+  int turnsWithoutProgress = 0;
+  int turn = 0;
+  std::unordered_map<uint64_t, int> turnsByState; // board hash -> the first turn it was seen at the end of
+  int repeatedTurn = 0;                            // the earlier turn of the last repeated board
+
+public:
+  enum class Reason
+  {
+    NONE,
+    NO_PROGRESS,
+    REPEATED_STATE
+  };
+
+  // starts from the board the game starts with
+  StalemateDetector(const StalemateRules &rules, const GameState &game);
+
+  // records the board at the end of a turn; NONE while the game is going somewhere
+  Reason endTurn(const GameState &game);
+
+  // why the game was found stalled, for its output
+  std::string explain(Reason reason) const;
+};
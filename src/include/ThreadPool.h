@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+    Fixed-size pool of worker threads running submitted tasks in submission order.
+    Each submit returns a future for the task's result (exceptions are rethrown by future::get).
+    The destructor finishes every task already submitted before joining the workers.
+*/
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+
+    void work();
+
+public:
+    // defaults to one worker per hardware thread (at least one)
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t getThreadCount() const;
+
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function &&function)
+    {
+        // std::function needs a copyable target, so the (move-only) packaged task is shared
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Function>()>>(std::forward<Function>(function));
+        auto result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task]()
+                          { (*task)(); });
+        }
+
+        condition.notify_one();
+
+        return result;
+    }
+};
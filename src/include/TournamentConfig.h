@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Stalemate.h"
+
+/*
+  Bounds on a tournament's size: the number of maps (M), players (P), games per
+  map (G) and turns per game (D). The defaults are the ones of the assignment.
+*/
+struct TournamentLimits
+{
+  int minMaps = 1, maxMaps = 5;
+  int minPlayers = 2, maxPlayers = 4;
+  int minGames = 1, maxGames = 5;
+  int minTurns = 10, maxTurns = 50;
+};
+
+/*
+  Everything a tournament needs to run without asking anything, read from
+  command line arguments and/or a config file.
+
+  Arguments are "-<key> <value>" pairs and a config file has one
+  "<key> = <value>" line per setting (# starts a comment); both take the same
+  keys, and arguments override the file (-config <path> loads it):
+
+    M          maps, comma-separated (names in the maps directory)
+    P          player strategies, comma-separated
+    G          games per map
+    D          turns per game
+    seed       tournament seed (a random one, printed in the log, if not set)
+    output     file the results table is written to
+    threads    threads per process (0: one per hardware thread, split between the processes)
+    processes  processes to split the games over (see GameEngine::startShardedTournament)
+    results    directory of the shards' result files
+    shard      k/N: only play shard k of N (to run it again), then merge; needs the
+               tournament's seed, so it plays the same games as the other shards
+    quiet      true/false: the games' messages aren't formatted (or printed), only the results
+    gamelog    true/false: the games write their orders and state changes to gamelog.txt (the default; the
+               tournament's results are logged either way)
+    stalemate  turns without a territory changing hands that end a game (0: never, the default)
+    repeats    true/false: a game whose board repeats an earlier turn's ends
+    stalemate-result
+               the result of a game ended either way ("Stalemate draw" by default)
+    maps-range, players-range, games-range, turns-range
+               min-max limits on M, P, G and D
+*/
+struct TournamentConfig
+{
+  std::vector<std::string> maps;
+  std::vector<std::string> players;
+  int numGames = 0;
+  int numTurns = 0;
+  bool hasSeed = false;
+  uint64_t seed = 0;
+  std::string outputPath;
+  size_t threads = 0;
+  size_t processes = 1;
+  std::string resultsDirectory = "tournament_shards";
+  size_t shard = 0; // from 1, 0 when the whole tournament is played
+  size_t shardCount = 0;
+  bool quiet = false;
+  bool gameLog = true;
+  StalemateRules stalemate;
+  TournamentLimits limits;
+
+  // sets one setting from its key and value; false (with the reason in `error`) if either is invalid
+  bool set(const std::string &key, const std::string &value, std::string &error);
+
+  // reads a config file; false (with the reason and line in `error`) if it can't be read or has an invalid line
+  bool loadFile(const std::string &path, std::string &error);
+
+  // reads "-<key> <value>" arguments, loading the -config file first if there is one
+  bool parseArguments(const std::vector<std::string> &arguments, std::string &error);
+
+  // checks every setting is there and within the limits
+  bool validate(std::string &error) const;
+};
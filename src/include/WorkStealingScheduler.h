@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/*
+    Runs a fixed batch of independent jobs of uneven length on a set of worker threads, keeping them all busy to the end.
+
+    The jobs are dealt round-robin, in the given order, to one deque per worker. A worker runs the jobs at the front
+    of its own deque; once it's empty, it steals from the back of the others' (where the jobs dealt last, expected to
+    be the shortest, wait). Dealing the jobs longest-expected-first therefore starts the long jobs early, and the short
+    ones fill the gaps at the end, so a batch takes little more than its longest job once there are enough workers.
+*/
+class WorkStealingScheduler
+{
+public:
+    struct WorkerStats
+    {
+        size_t jobs = 0;
+        size_t steals = 0; // jobs taken from another worker's deque
+        double busySeconds = 0;
+    };
+
+    struct Stats
+    {
+        double wallSeconds = 0;
+        std::vector<double> jobSeconds; // by job index
+        std::vector<WorkerStats> workers;
+
+        // longest single job, the lower bound of wallSeconds
+        double getLongestJobSeconds() const;
+
+        // share of the workers' time spent running jobs, in [0, 1]
+        double getUtilisation() const;
+    };
+
+    /// @brief Runs job(i) for every index i of `order` (a permutation of the job indexes) and waits for all of them
+    /// @param progress if given, called by the worker that finished a job, with the job and the number of jobs done so far
+    /// @details The first exception a job throws is rethrown once every worker has stopped; the jobs not started yet are skipped
+    static Stats run(size_t threadCount, const std::vector<size_t> &order, const std::function<void(size_t)> &job,
+                     const std::function<void(size_t, size_t)> &progress = nullptr);
+};